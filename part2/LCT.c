@@ -1,124 +1,442 @@
+#define _POSIX_C_SOURCE 199309L /* clock_gettime */
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
-typedef struct LCT *LCT;
-
-/* Represents a node in the LCT. */
-struct LCT {
-	/* Left Child */
-	LCT left;    
-	/* Right Child */
-  	LCT right;   
-  	/* General Parent Pointer. */
-	LCT hook;
-	/* The size of this sub-tree.*/
-  	int sum;
-};
-
-/************************************************** NOTE ********************************************************/
-/*  In this code we compare pointers with each others, this is only safe because in this project every node     */
-/*  belongs to the same array allocated in the begin of main. 											        */
-/****************************************************************************************************************/
-
-/************************************************ SIGNATURES ****************************************************/
-LCT allocLct(int V);
-void freeLCT(LCT t);
-
-/* Splaying Tree funtions */
-void rotateLeft(LCT node);
-void rotateRight(LCT node);
-void splayingStep(LCT node);
-void splay(LCT node);
-
-/* Link-Cut Trees functions*/
-void access(LCT t, int v);
-void link(LCT t, int u, int v);
-void cut(LCT t, int u, int v);
-int connectedQ(LCT t, int u, int v);
-void reRoot(LCT t, int v);
-
-/* Auxiliar funtions */
-void unflip(LCT node);
-int checkPrefPath(LCT t, int u, int v);
+#include "io.h"
+#include "LCT.h"
+#include "batch.h"
+#include "ett.h"
+#include "hdt.h"
+#include "snapshot.h"
+
+#ifndef LCT_NO_STATS
+THREAD_LOCAL Stats stats;
+#endif
+
+/* Forests that can replace the LCT with -b, for the commands of the Backend interface. */
+Backend * backends[] = { &ettBackend, &hdtBackend, NULL };
 
 /*****************************************************************************************************************/
-int main()
+int main(int argc, char * argv[])
 {
-	LCT vec = NULL;
-	int size, u, v;
+	Forest * vec = NULL;
+	LCT path;
+	MSF * msf = NULL;
+	Executor * ex = NULL;
+	Backend * backend = NULL;
+	void * forest = NULL;
+	Reader * in;
+	Writer * out, * log = NULL;
+	char * trace = NULL, * snapshot = NULL, * logPath = NULL;
+	int size, u, v, n, i, root = 0, threads = 1, epoch = 0;
+	long x, end, arg[MAX_ARGS];
 	int command;
-	clock_t begin, end;
-	double sum = 0;
-	scanf("%d\n", &size);
+	STAT(unsigned long begin;)
+
+	/* ./test [-j threads] [-b backend] [-s snapshot] [-l log] [trace], the trace is read from the standard input
+	   when it is not given */
+	for (i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+			threads = atoi(argv[++i]);
+		else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+			snapshot = argv[++i];
+		else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc)
+			logPath = argv[++i];
+		else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+		{
+			for (n = 0; backends[n] != NULL && strcmp(backends[n]->name, argv[i + 1]) != 0; n++)
+				;
+			if ((backend = backends[n]) == NULL && strcmp(argv[i + 1], "lct") != 0)
+			{
+				fprintf(stderr, "ERROR: Unknown backend %s\n", argv[i + 1]);
+				return EXIT_FAILURE;
+			}
+			i++;
+		}
+		else
+			trace = argv[i];
+	}
+
+	if ((in = openReader(trace)) == NULL)
+	{
+		fprintf(stderr, "ERROR: Can not open %s\n", trace);
+		return EXIT_FAILURE;
+	}
+	out = openWriter(stdout);
+	size = readSize(in);
+
+	/* the windows of -j and the snapshots are only for the LCT */
+	if (backend != NULL)
+		forest = backend->create(size);
+	else
+	{
+		/* the forest is restored from the snapshot and the commands logged after it */
+		if (snapshot != NULL && loadSnapshot(snapshot, &vec, &msf, &root, &epoch) < 0)
+		{
+			fprintf(stderr, "ERROR: %s is not a valid snapshot\n", snapshot);
+			return EXIT_FAILURE;
+		}
+		if (vec == NULL)
+			vec = allocLct(0);
+		if (logPath != NULL)
+		{
+			if (replayLog(logPath, vec, &msf, &root, epoch, &end) < 0 || (log = openLog(logPath, epoch, end)) == NULL)
+			{
+				fprintf(stderr, "ERROR: Can not use the log %s\n", logPath);
+				return EXIT_FAILURE;
+			}
+			/* an answer is only printed after the command is in the log */
+			out->first = log;
+		}
 
-	vec = allocLct(size);
-	while ((command = getchar()) != 'X' && EOF != command) /* reads the command and if its X exits the while cycle */
+		/* the nodes of the first line are created as V commands, so that the log creates them again */
+		while (vec->size < size)
+		{
+			newNode(vec);
+			if (log != NULL)
+				logCommand(log, 'V', arg);
+		}
+		if (threads > 1)
+			ex = createExecutor(threads, vec->size);
+	}
+
+	while ((command = readCommand(in, arg)) != EOF) /* reads the command and if its X exits the while cycle */
 	{  
-        getchar(); /* reads space after command */
+        u = (int)arg[0] - 1;
+        v = (int)arg[1] - 1;
+        x = arg[2];
+
+        if (backend != NULL)
+        {
+        	/* the backends index their vertices directly, so bad nodes are rejected as they are by the LCT */
+        	for (i = 0; i < arity(command) && i < 2 && arg[i] >= 1 && arg[i] <= size; i++)
+        		;
+        	if (i < arity(command) && i < 2)
+        	{
+        		writeString(out, "ERROR: Unknown node ");
+        		writeLong(out, arg[i]);
+        		writeChar(out, '\n');
+        		continue;
+        	}
+
+        	STAT(begin = now();)
+        	switch (command)
+        	{
+        		case 'L':
+        			backend->link(forest, u, v);
+        			break;
+
+        		case 'C':
+        			backend->cut(forest, u, v);
+        			break;
+
+        		case 'Q':
+        			writeChar(out, backend->connected(forest, u, v) ? 'T' : 'F');
+        			writeChar(out, '\n');
+        			break;
+
+        		case 'Z':
+        			writeLong(out, backend->size(forest, u));
+        			writeChar(out, '\n');
+        			break;
+
+        		default:
+        			writeString(out, "ERROR: Command not supported by the backend ");
+        			writeLong(out, command);
+        			writeChar(out, '\n');
+        	}
+        	STAT(recordOp(command, now() - begin);)
+        	continue;
+        }
+
+        /* the nodes of a command must exist, they can be created and deleted by V and K */
+        for (i = 0; i < arity(command) && i < 2 && aliveNode(vec, (int)arg[i] - 1); i++)
+        	;
+        if (i < arity(command) && i < 2)
+        {
+        	if (ex != NULL)
+        		runBatch(ex, vec, out);
+        	writeString(out, "ERROR: Unknown node ");
+        	writeLong(out, arg[i]);
+        	writeChar(out, '\n');
+        	continue;
+        }
+        if (log != NULL)
+        	logCommand(log, command, arg);
+
+        /* with several threads L, C and Q are collected in windows, any other command waits for the window */
+        if (ex != NULL)
+        {
+        	if (command == 'L' || command == 'C' || command == 'Q')
+        	{
+        		if (pushOp(ex, command, u, v))
+        			runBatch(ex, vec, out);
+        		continue;
+        	}
+        	runBatch(ex, vec, out);
+        }
+
+        STAT(begin = now();)
         switch (command) 
         {
 	        case 'L':
+	        	link(vec, u, v);
+	        	break;
 
-	        	scanf("%d %d",&u, &v);
+	        case 'C':
+	        	cut(vec, u, v);
+	        	break;
 
-	        	begin = clock();
-	        	link(vec, u-1, v-1);
-	        	end = clock();
+	        case 'Q':
+	        	writeChar(out, connectedQ(vec, u, v) ? 'T' : 'F');
+	        	writeChar(out, '\n');
+	        	break;
 
-	        	sum += (double)(end - begin) / CLOCKS_PER_SEC;
+	        case 'A':
+	        	pathAdd(vec, u, v, x);
 	        	break;
 
-	        case 'C':
-	        	scanf("%d %d",&u, &v);
+	        case 'S':
+	        	(path = exposePath(vec, u, v)) ? writeLong(out, path->sum) : writeChar(out, 'F');
+	        	writeChar(out, '\n');
+	        	break;
 
-	        	begin = clock();
-	        	cut(vec, u-1, v-1);
-	        	end = clock();
+	        case 'N':
+	        	if ((path = exposePath(vec, u, v)) != NULL)
+	        	{
+	        		writeLong(out, path->min);
+	        		writeChar(out, ' ');
+	        		writeLong(out, path->argmin->id + 1);
+	        	}
+	        	else
+	        		writeChar(out, 'F');
+	        	writeChar(out, '\n');
+	        	break;
 
-	        	sum += (double)(end - begin) / CLOCKS_PER_SEC;
+	        case 'M':
+	        	(path = exposePath(vec, u, v)) ? writeLong(out, path->max) : writeChar(out, 'F');
+	        	writeChar(out, '\n');
 	        	break;
 
-	        case 'Q':
-	        	scanf("%d %d", &u, &v);
-	        	(connectedQ(vec, u-1, v-1)) ? printf("T\n") : printf("F\n");
+	        case 'Z':
+	        	writeLong(out, componentSize(vec, u));
+	        	writeChar(out, '\n');
+	        	break;
+
+	        case 'T':
+	        	(n = subtreeSize(vec, u, v)) ? writeLong(out, n) : writeChar(out, 'F');
+	        	writeChar(out, '\n');
+	        	break;
+
+	        case 'R':
+	        	root = u;
+	        	break;
+
+	        case 'P':
+	        	(path = lowestCommonAncestor(vec, root, u, v)) ? writeLong(out, path->id + 1) : writeChar(out, 'F');
+	        	writeChar(out, '\n');
+	        	break;
+
+	        case 'D':
+	        	((n = distance(vec, u, v)) >= 0) ? writeLong(out, n) : writeChar(out, 'F');
+	        	writeChar(out, '\n');
+	        	break;
+
+	        case 'W':
+	        	/* only traces with weighted edges pay for it, it grows with the forest */
+	        	if (msf == NULL) msf = createMSF(vec->size); else growMSF(msf, vec->size);
+	        	writeLong(out, insertEdge(msf, u, v, x));
+	        	writeChar(out, '\n');
+	        	break;
+
+	        case 'E':
+	        	if (msf == NULL) msf = createMSF(vec->size); else growMSF(msf, vec->size);
+	        	if ((path = heaviestEdge(msf, u, v)) != NULL)
+	        	{
+	        		writeLong(out, path->val);
+	        		writeChar(out, ' ');
+	        		writeLong(out, msf->endA[path->id / 2] + 1);
+	        		writeChar(out, ' ');
+	        		writeLong(out, msf->endB[path->id / 2] + 1);
+	        	}
+	        	else
+	        		writeChar(out, 'F');
+	        	writeChar(out, '\n');
+	        	break;
+	    
+	        case 'V':
+	        	writeLong(out, newNode(vec) + 1);
+	        	writeChar(out, '\n');
+	        	break;
+
+	        case 'K':
+	        	deleteVertex(vec, msf, u);
+	        	break;
+
+	        case 'B':
+	        	/* a new snapshot has everything the log had, so the log starts again */
+	        	if (snapshot == NULL || !saveSnapshot(snapshot, vec, msf, root, epoch + 1))
+	        		writeString(out, "ERROR: Can not write the snapshot\n");
+	        	else if (log != NULL)
+	        	{
+	        		closeLog(log);
+	        		out->first = log = openLog(logPath, ++epoch, 0);
+	        	}
+	        	else
+	        		epoch++;
 	        	break;
 	    
 	 		default:
-	            printf("ERROR: Unknown command %d\n",(int)command);
+	 			writeString(out, "ERROR: Unknown command ");
+	 			writeLong(out, command);
+	 			writeChar(out, '\n');
 	    }
-	    getchar(); /* reads the \n */
+	    STAT(recordOp(command, now() - begin);)
     }
 
+    if (ex != NULL)
+    {
+    	runBatch(ex, vec, out);
+    	freeExecutor(ex);
+    }
     if (vec != NULL) freeLCT(vec); 
+    if (forest != NULL) backend->destroy(forest);
+    if (msf != NULL) freeMSF(msf);
+    closeWriter(out);
+    if (log != NULL) closeLog(log);
+    closeReader(in);
 
-    printf("Amortized execution time: %f\n", sum);
+    STAT(printStats(stderr);)
 	return EXIT_SUCCESS;
 }
 
-/* @brief: Function to allocate an array of nodes of type LCT. 
+/* @brief: Function to allocate a forest with V nodes, numbered from 0 to V-1, without edges.
  *		   Receives an integer which defines the number of nodes.
  */
-LCT allocLct(int V)
+Forest* allocLct(int V)
+{
+	Forest * t = (Forest*) malloc(sizeof(Forest));
+
+	t->nChunks = 0;
+	t->maxChunks = 16;
+	t->chunks = (LCT*) malloc(sizeof(LCT)*t->maxChunks);
+	t->size = 0;
+	t->nFree = 0;
+	t->maxFree = 16;
+	t->freeIds = (int*) malloc(sizeof(int)*t->maxFree);
+
+	while (t->size < V)
+		newNode(t);
+
+	return t;
+}
+
+/* @brief: Function to free the memory of a forest.
+ *		   Receives a pointer to the forest.
+ */
+void freeLCT(Forest * t)
 {
 	int i;
-	LCT nodes = (LCT) malloc(sizeof(struct LCT)*V);
-	for( i = 0; i < V; i++)
+
+	for (i = 0; i < t->nChunks; i++)
+		free(t->chunks[i]);
+	free(t->chunks);
+	free(t->freeIds);
+	free(t);
+}
+
+/* @brief: Function that adds a node without edges to the forest. The last deleted node is reused when there is
+ *		   one, otherwise the node after the last one is taken and a new chunk is allocated when the last is full.
+ *		   The nodes never move, so the pointers between them stay valid.
+ *
+ *		   Receives the forest.
+ *		   Returns the handle of the node.
+ */
+int newNode(Forest * t)
+{
+	int v;
+	LCT node;
+
+	if (t->nFree > 0)
+		v = t->freeIds[--t->nFree];
+	else
 	{
-		nodes[i].left = NULL;
-		nodes[i].right = NULL;
-		nodes[i].hook = NULL;
-		nodes[i].sum = 1;
+		if ((t->size & CHUNK_MASK) == 0)
+		{
+			if (t->nChunks == t->maxChunks)
+			{
+				t->maxChunks *= 2;
+				t->chunks = (LCT*) realloc(t->chunks, sizeof(LCT)*t->maxChunks);
+			}
+			t->chunks[t->nChunks++] = (LCT) malloc(sizeof(struct LCT) << CHUNK_BITS);
+		}
+		v = t->size++;
 	}
-	return nodes;
+
+	node = NODE(t, v);
+	node->left = NULL;
+	node->right = NULL;
+	node->hook = NULL;
+	node->flip = 1;
+	node->size = 1;
+	node->vir = 0;
+	node->tot = 1;
+	node->val = node->sum = node->min = node->max = 0;
+	node->argmin = node->argmax = node;
+	node->add = 0;
+	node->id = v;
+	node->vertex = 0;
+
+	return v;
 }
 
-/* @brief: Function to free the memory of the array representing the nodes. 
- *		   Receives a pointer to the begining of the array.
+/* @brief: Function that removes a node from the forest, only when it has no edges. Its handle is given again by
+ *		   the next newNode.
+ *
+ *		   Receives the forest and the handle of the node.
+ *		   Returns 1 if the node was removed.
  */
-void freeLCT(LCT t)
+int deleteNode(Forest * t, int v)
 {
-	free(t);
+	if (componentSize(t, v) != 1)
+		return 0;
+
+	if (t->nFree == t->maxFree)
+	{
+		t->maxFree *= 2;
+		t->freeIds = (int*) realloc(t->freeIds, sizeof(int)*t->maxFree);
+	}
+	t->freeIds[t->nFree++] = v;
+	NODE(t, v)->id = -1;
+
+	return 1;
+}
+
+/* @brief: Function that deletes a vertex, only when it has no edges in the forest and in the minimum spanning
+ *		   forest, since its handle is given to the next new vertex.
+ *
+ *		   Receives the forest, the minimum spanning forest (or NULL) and the vertex.
+ *		   Returns 1 if the vertex was deleted.
+ */
+int deleteVertex(Forest * t, MSF * msf, int v)
+{
+	if (msf != NULL && v < msf->V && componentSize(msf->nodes, MSF_VERTEX(v)) != 1)
+		return 0;
+	return deleteNode(t, v);
+}
+
+/* @brief: Function that checks if a handle belongs to a node of the forest that was not deleted. The node is
+ *		   only read when some handle is deleted, so that the check does not touch memory in the common case.
+ *
+ *		   Receives the forest and the handle.
+ */
+int aliveNode(Forest * t, int v)
+{
+	return v >= 0 && v < t->size && (t->nFree == 0 || NODE(t, v)->id == v);
 }
 
 /* @brief: Function that rotates a specific node to the right. 
@@ -148,6 +466,10 @@ void rotateRight(LCT node)
   	parent->left = node->right;
   	node->right = parent;
   	parent->hook = node;
+  	STAT(stats.rotations++;)
+
+  	update(parent);
+  	update(node);
 }
 
 
@@ -178,6 +500,10 @@ void rotateLeft(LCT node)
 	parent->right = node->left;
 	node->left = parent;
 	parent->hook = node;
+	STAT(stats.rotations++;)
+
+	update(parent);
+	update(node);
 }
 
 /* @brief: Splays a node according to the definition of the splaying step from paper "Self Adjusting Binary Search 
@@ -191,9 +517,9 @@ void splayingStep(LCT node)
 	LCT g_parent = parent->hook; /* parent is never NULL because we only call this while parent != NULL */
 
 	if (g_parent != NULL)
-		unflip(g_parent);
-	unflip(parent);
-	unflip(node);
+		pushDown(g_parent);
+	pushDown(parent);
+	pushDown(node);
 
 	/* Case 1 ZIG */
 	if (g_parent == NULL && (parent->right == node))
@@ -243,8 +569,8 @@ void splay(LCT node)
 {
 	if (node != NULL)
 	{
-		/* unflip nodes */
-		unflip(node);
+		/* unflip nodes and push pending additions */
+		pushDown(node);
 
 		/* While hook =! NULL or node hook doesnt point back to node */
 		while (1)
@@ -263,91 +589,118 @@ void splay(LCT node)
  *         This function was defined according with whats defined in "A Data Structure for Dynamic trees" paper
  *         from Sleator and Tarjan.
  *
- *         Receives an array with all LCT nodes and a int v that represents the position of the node we want
- *         to access in that array.
+ *         Receives the forest with all LCT nodes and a int v that represents the handle of the node we want
+ *         to access.
+ *         Returns the last node where the path from v joined the old prefered path of the root, which is v itself
+ *         when v was already in it.
  */
-void access(LCT t, int v)
+LCT access(Forest * t, int v)
 {
-	LCT node = &t[v];
-	LCT w = NULL;
+	LCT node = NODE(t, v);
+	LCT w = node;
+	STAT(stats.accesses++;)
 	splay(node);
+	/* the old prefered child becomes a virtual sub-tree */
+	if (node->right != NULL)
+		node->vir += node->right->tot;
 	node->right = NULL;
+	update(node);
 
 	while (node->hook !=  NULL)
 	{
 		w = node->hook;
+		STAT(stats.pathChanges++;)
 		splay(w);
+		/* node stops being a virtual sub-tree of w and w's old prefered child becomes one */
+		if (w->right != NULL)
+			w->vir += w->right->tot;
+		w->vir -= node->tot;
 		w->right = node;
+		update(w);
 		splay(node);
 	}
+
+	return w;
 }
 
 /* @brief: Adds the edge from r to v to the represented tree. Before linking the node r is made the root of 
  *         its represented tree.
  *
- *         Receives an array with all LCT nodes, int u that represents the position of the node u and int v that 
+ *         Receives the forest with all LCT nodes, int u that represents the position of the node u and int v that 
  *         represents the position of the node v.
  */
-void link(LCT t, int r, int v)
+void link(Forest * t, int r, int v)
 {
-	/* specific part for this project */
-	if (connectedQ(t, r, v))
-		return;
-	
+	LCT root = NODE(t, r), node = NODE(t, v);
+
 	reRoot(t, r);
-	/* actual link operations */
-	access(t, v);
-	t[r].left = &t[v]; 
-	t[v].hook = &t[r];  
+	/* specific part for this project, after the reRoot r is the root of v's tree if they are connected */
+	if (findRoot(t, v) == root)
+		return;
+
+	/* actual link operations, r is the root of its aux tree and of its represented tree so it only needs a 
+	   path parent. v is splayed to the top of the root path so that adding r to its virtual sub-trees does 
+	   not change any other node. */
+	splay(node);
+	root->hook = node;
+	node->vir += root->tot;
+	update(node);
 }
 
 /* @brief: This function removes the edge (u, v).
  *
- *         Receives an array with all LCT nodes, int u that represents the position of the node u and int v that 
+ *         Receives the forest with all LCT nodes, int u that represents the position of the node u and int v that 
  *         represents the position of the node v.
  */
-void cut(LCT t, int r, int v)
+void cut(Forest * t, int r, int v)
 {	
+	LCT root = NODE(t, r), node = NODE(t, v);
+
 	/* specific part for this project */
 	reRoot(t, r);
 	/* actual link operations */
 	access(t, v);
-	if (t[v].left == &t[r] && t[r].right == NULL)
+	pushDown(root);
+	if (node->left == root && root->right == NULL)
 	{
-		t[v].left->hook = NULL;
-		t[v].left = NULL;
+		root->hook = NULL;
+		node->left = NULL;
+		update(node);
 	}
 }
 
-/* @brief: This function checks if a node u and a node v are in the same path. We assume that node u has a depth 
- *         higher than v.
+/* @brief: Funtion that verifies if there is a path between a node u and a node v.
  *
- *         Receives an array with all LCT nodes, int u that represents the position of the node u and int v that 
+ *         Receives the forest with all LCT nodes, int u that represents the position of the node u and int v that 
  *         represents the position of the node v.
  */
-int checkPrefPath(LCT t, int u, int v)
+int connectedQ(Forest * t, int u, int v)
 {
-	LCT current = &t[u];
-
-	while (current->hook != NULL)
-	{
-		if (current->hook == &t[v]) return 1;
-		current = current->hook;
-	}
-
-	return 0;
+	if (u == v)
+		return 1;
+	return findRoot(t, u) == findRoot(t, v);
 }
 
-/* @brief: Funtion that verifies if there is a path between a node u and a node v.
+/* @brief: Funtion that finds the root of the represented tree of a node v. After the access the root is the 
+ *         leftmost node of the aux tree of v, it is splayed so that the next findRoot on this tree is cheap.
  *
- *         Receives an array with all LCT nodes, int u that represents the position of the node u and int v that 
- *         represents the position of the node v.
+ *         Receives the forest with all LCT nodes, int v that represents the node whose root we want.
+ *         Returns a pointer to the root.
  */
-int connectedQ(LCT t, int u, int v)
+LCT findRoot(Forest * t, int v)
 {
-	reRoot(t, u);
+	LCT node = NODE(t, v);
+
 	access(t, v);
-	return checkPrefPath(t, u, v);
+	pushDown(node);
+	while (node->left != NULL)
+	{
+		node = node->left;
+		pushDown(node);
+	}
+	splay(node);
+
+	return node;
 }
 
 /* @brief: Funtion that unflips a node if he is fliped.
@@ -358,7 +711,7 @@ void unflip(LCT node)
 {
 	LCT aux;
 
-	if (node->sum != -1)
+	if (node->flip != -1)
 		return;
 
 	/* switch right with left */
@@ -368,20 +721,425 @@ void unflip(LCT node)
 
 	/* flip right and left childs bits */
 	if (node->right != NULL)
-		node->right->sum *= -1;
+		node->right->flip *= -1;
+	if (node->left != NULL)
+		node->left->flip *= -1;
+	/* restore flip bit */
+	node->flip = 1;
+}
+
+/* @brief: Funtion that adds a value to every node of a splay sub-tree. The node itself and its aggregates are 
+ *         updated right away, its children only when the addition is pushed down.
+ *
+ *         Receives the root of the sub-tree and the value to add.
+ */
+void applyAdd(LCT node, long x)
+{
+	node->val += x;
+	node->sum += x * node->size;
+	node->min += x;
+	node->max += x;
+	node->add += x;
+}
+
+/* @brief: Funtion that pushes the pending flip and addition of a node to its children.
+ *
+ *         Receives the node we want to push.
+ */
+void pushDown(LCT node)
+{
+	unflip(node);
+
+	if (node->add == 0)
+		return;
+
 	if (node->left != NULL)
-		node->left->sum *= -1;
-	/* restore sum bit */
-	node->sum = 1;
+		applyAdd(node->left, node->add);
+	if (node->right != NULL)
+		applyAdd(node->right, node->add);
+	node->add = 0;
+}
+
+/* @brief: Funtion that recomputes the size and the path aggregates of a node from its children. The flip bits 
+ *         and pending additions of the children do not need to be pushed because they do not change them.
+ *
+ *         Receives the node we want to update.
+ */
+void update(LCT node)
+{
+	LCT child;
+
+	node->size = 1;
+	node->tot = 1 + node->vir;
+	node->sum = node->min = node->max = node->val;
+	node->argmin = node;
+	node->argmax = node->vertex ? NULL : node;
+
+	if ((child = node->left) != NULL)
+	{
+		node->size += child->size;
+		node->tot += child->tot;
+		node->sum += child->sum;
+		if (child->min < node->min) { node->min = child->min; node->argmin = child->argmin; }
+		if (child->argmax != NULL && (node->argmax == NULL || child->max > node->max))
+			{ node->max = child->max; node->argmax = child->argmax; }
+	}
+	if ((child = node->right) != NULL)
+	{
+		node->size += child->size;
+		node->tot += child->tot;
+		node->sum += child->sum;
+		if (child->min < node->min) { node->min = child->min; node->argmin = child->argmin; }
+		if (child->argmax != NULL && (node->argmax == NULL || child->max > node->max))
+			{ node->max = child->max; node->argmax = child->argmax; }
+	}
 }
 
 /* @brief: Funtion that makes v the root of the represented tree.
  *
- *         Receives an array with all LCT nodes, int v that represents the node we want to make the root.
+ *         Receives the forest with all LCT nodes, int v that represents the node we want to make the root.
  */
-void reRoot(LCT t, int v)
+void reRoot(Forest * t, int v)
 {
 	access(t, v);
-	t[v].sum *= -1; /* invert node */
+	NODE(t, v)->flip *= -1; /* invert node, v stays the root of its aux tree */
+}
+
+/* @brief: Funtion that makes the path between u and v the prefered path, with u as the root of the represented
+ *         tree. After this call the aux tree rooted at v holds exactly the nodes of that path, so its aggregates
+ *         are the path aggregates.
+ *
+ *         Receives the forest with all LCT nodes, int u and int v that represent the ends of the path.
+ *         Returns the root of the aux tree of the path or NULL if u and v are not connected.
+ */
+LCT exposePath(Forest * t, int u, int v)
+{
+	reRoot(t, u);
+	if (findRoot(t, v) != NODE(t, u))
+		return NULL;
+	/* v is the last node of the prefered path from u so after the splay its aux tree is exactly the path */
+	splay(NODE(t, v));
+	return NODE(t, v);
+}
+
+/* @brief: Adds x to the value of every node in the path between u and v. Nothing is done if u and v are not
+ *         connected.
+ *
+ *         Receives the forest with all LCT nodes, int u and int v that represent the ends of the path and the
+ *         value to add.
+ */
+void pathAdd(Forest * t, int u, int v, long x)
+{
+	LCT path = exposePath(t, u, v);
+
+	if (path != NULL)
+		applyAdd(path, x);
+}
+
+/* @brief: Funtion that changes the value of a node v. v is accessed first so that it is the root of the top aux
+ *         tree and no other aggregate depends on its value.
+ *
+ *         Receives the forest with all LCT nodes, int v that represents the node and its new value.
+ */
+void setValue(Forest * t, int v, long x)
+{
+	access(t, v);
+	NODE(t, v)->val = x;
+	update(NODE(t, v));
+}
+
+/* @brief: Funtion that computes the number of nodes in the represented tree of v. After the access the aux tree
+ *         of v holds the path from the root, so its total counts the whole tree.
+ *
+ *         Receives the forest with all LCT nodes and int v that represents the node.
+ */
+int componentSize(Forest * t, int v)
+{
 	access(t, v);
+	return NODE(t, v)->tot;
+}
+
+/* @brief: Funtion that computes the number of nodes in the sub-tree of v when the represented tree is rooted 
+ *         at u. After exposing the path from u to v every descendant of v hangs from it in a virtual sub-tree.
+ *
+ *         Receives the forest with all LCT nodes, int u that represents the root and int v that represents the
+ *         node whose sub-tree we want.
+ *         Returns the size of the sub-tree or 0 if u and v are not connected.
+ */
+int subtreeSize(Forest * t, int u, int v)
+{
+	LCT path = exposePath(t, u, v);
+
+	return (path != NULL) ? path->vir + 1 : 0;
+}
+
+/* @brief: Function to allocate an empty minimum spanning forest over V vertices.
+ *		   Receives an integer which defines the number of vertices.
+ */
+MSF* createMSF(int V)
+{
+	MSF * msf = (MSF*) malloc(sizeof(MSF));
+
+	msf->V = 0;
+	msf->nodes = allocLct(0);
+	msf->endA = msf->endB = msf->freeEdges = NULL;
+	msf->nFree = 0;
+	msf->weight = 0;
+	growMSF(msf, V);
+
+	return msf;
+}
+
+/* @brief: Function that adds vertices to a minimum spanning forest until it has V of them, each new vertex comes
+ *		   with room for one more edge.
+ *
+ *		   Receives the forest and the number of vertices.
+ */
+void growMSF(MSF * msf, int V)
+{
+	int i, v;
+
+	if (V <= msf->V)
+		return;
+
+	msf->endA = (int*) realloc(msf->endA, sizeof(int)*V);
+	msf->endB = (int*) realloc(msf->endB, sizeof(int)*V);
+	msf->freeEdges = (int*) realloc(msf->freeEdges, sizeof(int)*V);
+
+	for (i = msf->V; i < V; i++)
+	{
+		v = newNode(msf->nodes);
+		NODE(msf->nodes, v)->vertex = 1;
+		update(NODE(msf->nodes, v));
+		newNode(msf->nodes);
+	}
+	/* pushed in reverse so that edges are taken in order */
+	for (i = V - 1; i >= msf->V; i--)
+		msf->freeEdges[msf->nFree++] = i;
+	msf->V = V;
+}
+
+/* @brief: Function to free the memory of a minimum spanning forest.
+ *		   Receives a pointer to the forest.
+ */
+void freeMSF(MSF * msf)
+{
+	freeLCT(msf->nodes);
+	free(msf->endA);
+	free(msf->endB);
+	free(msf->freeEdges);
+	free(msf);
+}
+
+/* @brief: Inserts the edge (u, v) with weight w in the minimum spanning forest. If u and v are already connected
+ *         the edge replaces the heaviest edge of the path between them when it is lighter, otherwise it is 
+ *         discarded.
+ *
+ *         Receives the forest, int u and int v that represent the ends of the edge and its weight.
+ *         Returns the total weight of the forest after the insertion.
+ */
+long insertEdge(MSF * msf, int u, int v, long w)
+{
+	Forest * t = msf->nodes;
+	LCT heavy;
+	int e;
+
+	if (u == v)
+		return msf->weight;
+
+	if ((heavy = heaviestEdge(msf, u, v)) != NULL)
+	{
+		if (heavy->val <= w)
+			return msf->weight;
+
+		/* the heaviest edge leaves the forest and its node is reused for the new edge */
+		e = heavy->id / 2;
+		msf->weight -= heavy->val;
+		cut(t, MSF_VERTEX(msf->endA[e]), MSF_EDGE(e));
+		cut(t, MSF_EDGE(e), MSF_VERTEX(msf->endB[e]));
+	}
+	else
+		e = msf->freeEdges[--msf->nFree];
+
+	msf->endA[e] = u;
+	msf->endB[e] = v;
+	setValue(t, MSF_EDGE(e), w);
+	link(t, MSF_VERTEX(u), MSF_EDGE(e));
+	link(t, MSF_EDGE(e), MSF_VERTEX(v));
+	msf->weight += w;
+
+	return msf->weight;
+}
+
+/* @brief: Finds the heaviest edge of the path between u and v in the minimum spanning forest.
+ *
+ *         Receives the forest, int u and int v that represent the ends of the path.
+ *         Returns the node of that edge or NULL if u and v are not connected or u == v.
+ */
+LCT heaviestEdge(MSF * msf, int u, int v)
+{
+	LCT path;
+
+	if (u == v || (path = exposePath(msf->nodes, MSF_VERTEX(u), MSF_VERTEX(v))) == NULL)
+		return NULL;
+
+	return path->argmax;
+}
+
+/* @brief: Finds the lowest common ancestor of u and v when the tree is rooted at r. The tree is only rerooted
+ *         when some other operation moved its root away from r, so a sequence of queries for the same root does
+ *         not change the represented tree. After accessing u, the access of v joins the path of u at the lowest
+ *         common ancestor.
+ *
+ *         Receives the forest with all LCT nodes, int r that represents the root, int u and int v.
+ *         Returns the lowest common ancestor or NULL if u or v are not in the tree of r.
+ */
+LCT lowestCommonAncestor(Forest * t, int r, int u, int v)
+{
+	LCT root = findRoot(t, u);
+
+	if (root != NODE(t, r))
+	{
+		if (findRoot(t, r) != root)
+			return NULL;
+		reRoot(t, r);
+	}
+	if (findRoot(t, v) != NODE(t, r))
+		return NULL;
+
+	access(t, u);
+	return access(t, v);
+}
+
+/* @brief: Funtion that computes the number of edges in the path between u and v, which does not depend on the
+ *         root. After exposing the path its aux tree holds exactly its nodes.
+ *
+ *         Receives the forest with all LCT nodes, int u and int v.
+ *         Returns the distance or -1 if u and v are not connected.
+ */
+int distance(Forest * t, int u, int v)
+{
+	LCT path = exposePath(t, u, v);
+
+	return (path != NULL) ? path->size - 1 : -1;
+}
+
+#ifndef LCT_NO_STATS
+/* @brief: Function that reads the monotonic clock, in nanoseconds. 
+ */
+unsigned long now()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long)ts.tv_sec * 1000000000UL + (unsigned long)ts.tv_nsec;
+}
+
+/* @brief: Function that adds the latency of a command to its histogram. The bucket is given by the position of 
+ *         the highest bit of ns followed by the next HIST_SUB bits.
+ *
+ *		   Receives the command letter and its latency in nanoseconds.
+ */
+void recordOp(int command, unsigned long ns)
+{
+	Histogram * h;
+	int bit = 0;
+
+	if (command < 'A' || command > 'Z')
+		return;
+	h = &stats.commands[command - 'A'];
+
+	while ((ns >> bit) >= (1UL << (HIST_SUB + 1)))
+		bit++;
+	h->buckets[(bit << HIST_SUB) + (ns >> bit)]++;
+
+	h->count++;
+	h->total += ns;
+	if (ns > h->max)
+		h->max = ns;
+}
+
+/* @brief: Function that adds the counters and histograms of a thread to another one.
+ *
+ *		   Receives the statistics that are updated and the ones that are added to them.
+ */
+void mergeStats(Stats * into, Stats * from)
+{
+	Histogram * a, * b;
+	int c, i;
+
+	into->rotations += from->rotations;
+	into->accesses += from->accesses;
+	into->pathChanges += from->pathChanges;
+
+	for (c = 0; c < 26; c++)
+	{
+		a = &into->commands[c];
+		b = &from->commands[c];
+		if (b->count == 0)
+			continue;
+		a->count += b->count;
+		a->total += b->total;
+		if (b->max > a->max)
+			a->max = b->max;
+		for (i = 0; i < HIST_BUCKETS; i++)
+			a->buckets[i] += b->buckets[i];
+	}
+}
+
+/* @brief: Function that computes a percentile of a histogram. 
+ *
+ *		   Receives the histogram and the fraction q of the latencies that must be below the result.
+ *		   Returns the upper bound of the bucket where the percentile falls, in nanoseconds.
+ */
+unsigned long percentile(Histogram * h, double q)
+{
+	unsigned long seen = 0, rank = (unsigned long)(q * h->count), bound;
+	int i, bit;
+
+	if (rank >= h->count)
+		rank = h->count - 1;
+
+	for (i = 0; i < HIST_BUCKETS; i++)
+	{
+		seen += h->buckets[i];
+		if (seen > rank)
+			break;
+	}
+
+	/* bucket i holds values v with v >> bit == i - (bit << HIST_SUB) */
+	bit = (i >> HIST_SUB) - 1;
+	bound = (bit < 0) ? (unsigned long)i : ((unsigned long)(i - (bit << HIST_SUB) + 1) << bit) - 1;
+
+	return (bound < h->max) ? bound : h->max;
+}
+
+/* @brief: Function that prints the latency percentiles of every command that was used and the LCT counters.
+ *		   Receives the stream where they are printed.
+ */
+void printStats(FILE * out)
+{
+	Histogram * h;
+	unsigned long ops = 0;
+	double ns = 0;
+	int c;
+
+	fprintf(out, "%-3s %12s %10s %10s %10s %10s %10s (ns)\n", "cmd", "count", "mean", "p50", "p99", "p999", "max");
+	for (c = 0; c < 26; c++)
+	{
+		h = &stats.commands[c];
+		if (h->count == 0)
+			continue;
+		ops += h->count;
+		ns += h->total;
+		fprintf(out, "%-3c %12lu %10.0f %10lu %10lu %10lu %10lu\n", 'A' + c, h->count, h->total / h->count,
+			percentile(h, 0.5), percentile(h, 0.99), percentile(h, 0.999), h->max);
+	}
+
+	/* the time spent inside the commands, without reading and writing */
+	fprintf(out, "commands: %lu in %.3f s (%.0f per second)\n", ops, ns / 1e9, ns > 0 ? ops / (ns / 1e9) : 0.0);
+	fprintf(out, "rotations: %lu (%.2f per command)\n", stats.rotations, ops ? (double)stats.rotations / ops : 0.0);
+	fprintf(out, "accesses: %lu (%.2f prefered path changes per access)\n", stats.accesses, 
+		stats.accesses ? (double)stats.pathChanges / stats.accesses : 0.0);
 }
+#endif
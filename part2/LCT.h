@@ -0,0 +1,200 @@
+#ifndef LCT_H
+#define LCT_H
+
+#include <stdio.h>
+
+/* Per command latency histograms and LCT counters, compile with -DLCT_NO_STATS to remove them. */
+#ifndef LCT_NO_STATS
+#define STAT(statement) statement
+#else
+#define STAT(statement)
+#endif
+
+typedef struct LCT *LCT;
+
+/* Represents a node in the LCT. */
+struct LCT {
+	/* Left Child */
+	LCT left;    
+	/* Right Child */
+  	LCT right;   
+  	/* General Parent Pointer. */
+	LCT hook;
+	/* Flip bit, -1 when the children of this node still have to be switched. */
+  	int flip;
+	/* Number of nodes in this splay sub-tree. */
+	int size;
+	/* Number of nodes in the virtual sub-trees of this node, the ones hanging from it by path parent pointers. */
+	int vir;
+	/* Number of nodes in this splay sub-tree plus all their virtual sub-trees. */
+	int tot;
+	/* Value stored in this node. */
+	long val;
+	/* Sum, minimum and maximum of the values in this splay sub-tree. */
+	long sum;
+	long min;
+	long max;
+	/* Nodes of this splay sub-tree that hold the minimum and the maximum values. */
+	LCT argmin;
+	LCT argmax;
+	/* Value still to be added to every node below this one (already applied to this node). */
+	long add;
+	/* Handle of this node in its forest, -1 while the node is deleted. */
+	int id;
+	/* 1 for the vertices of a minimum spanning forest, left out of the maximum (argmax is NULL when only they are). */
+	int vertex;
+};
+
+/* Every chunk of a forest holds 2^CHUNK_BITS nodes. */
+#define CHUNK_BITS 12
+#define CHUNK_MASK ((1 << CHUNK_BITS) - 1)
+
+/* Node of a forest given its handle. */
+#define NODE(t, v) (&(t)->chunks[(v) >> CHUNK_BITS][(v) & CHUNK_MASK])
+
+/*
+ * @brief: Nodes of an LCT, kept in chunks that are never moved so that the forest can grow without changing the
+ *         pointers between nodes. A node is named by its handle, the handles of the deleted nodes are kept in a
+ *         stack and given again to the next new nodes.
+ */
+typedef struct
+{
+	LCT * chunks;
+	int nChunks;
+	int maxChunks;
+	/* handles given so far, 0..size-1 */
+	int size;
+	int * freeIds;
+	int nFree;
+	int maxFree;
+
+} Forest;
+
+/*
+ * @brief: Minimum spanning forest of the weighted edges inserted so far. It uses its own LCT where vertex v is the
+ *         node MSF_VERTEX(v) and the k-th edge is the node MSF_EDGE(k), so that the weight of an edge is the
+ *         value of its node and the heaviest edge of a path is given by the path maximum. Vertices are flagged so
+ *         that update leaves them out of the maximum, so any weight works. The two kinds of nodes alternate so
+ *         that the forest grows with the vertices.
+ */
+typedef struct
+{
+	int V;
+	Forest * nodes;
+	/* ends of each edge */
+	int * endA;
+	int * endB;
+	/* stack of edges that are not in the forest */
+	int * freeEdges;
+	int nFree;
+	/* total weight of the forest */
+	long weight;
+
+} MSF;
+
+#define MSF_VERTEX(v) (2*(v))
+#define MSF_EDGE(k) (2*(k) + 1)
+
+#ifndef LCT_NO_STATS
+/* Each power of two of nanoseconds is split in 2^HIST_SUB buckets, so percentiles are within 1/2^HIST_SUB. */
+#define HIST_SUB 3
+#define HIST_BUCKETS (64 << HIST_SUB)
+
+/*
+ * @brief: Log-scale histogram of the latencies of one command, in nanoseconds.
+ */
+typedef struct
+{
+	unsigned long count;
+	unsigned long max;
+	double total;
+	unsigned long buckets[HIST_BUCKETS];
+
+} Histogram;
+
+/*
+ * @brief: Counters kept by the LCT functions and one histogram per command letter.
+ */
+typedef struct
+{
+	unsigned long rotations;
+	unsigned long accesses;
+	/* prefered path changes, one for each path parent followed by access */
+	unsigned long pathChanges;
+	Histogram commands[26];
+
+} Stats;
+
+/* Every thread keeps its own counters, the batch executor merges them when a batch ends. */
+#ifdef __GNUC__
+#define THREAD_LOCAL __thread
+#else
+#define THREAD_LOCAL
+#endif
+
+extern THREAD_LOCAL Stats stats;
+#endif
+
+/************************************************** NOTE ********************************************************/
+/*  In this code we only compare pointers for equality and the nodes never move once allocated, so a node can   */
+/*  be turned back into its handle with its id field and not by subtracting the begin of an array.              */
+/****************************************************************************************************************/
+
+/************************************************ SIGNATURES ****************************************************/
+Forest* allocLct(int V);
+void freeLCT(Forest * t);
+int newNode(Forest * t);
+int deleteNode(Forest * t, int v);
+int aliveNode(Forest * t, int v);
+int deleteVertex(Forest * t, MSF * msf, int v);
+
+/* Splaying Tree funtions */
+void rotateLeft(LCT node);
+void rotateRight(LCT node);
+void splayingStep(LCT node);
+void splay(LCT node);
+
+/* Link-Cut Trees functions*/
+LCT access(Forest * t, int v);
+void link(Forest * t, int u, int v);
+void cut(Forest * t, int u, int v);
+int connectedQ(Forest * t, int u, int v);
+void reRoot(Forest * t, int v);
+LCT findRoot(Forest * t, int v);
+
+/* Path aggregate functions */
+LCT exposePath(Forest * t, int u, int v);
+void pathAdd(Forest * t, int u, int v, long x);
+
+/* Minimum spanning forest functions */
+MSF* createMSF(int V);
+void growMSF(MSF * msf, int V);
+void freeMSF(MSF * msf);
+long insertEdge(MSF * msf, int u, int v, long w);
+LCT heaviestEdge(MSF * msf, int u, int v);
+
+/* Sub-tree size functions */
+int componentSize(Forest * t, int v);
+int subtreeSize(Forest * t, int u, int v);
+
+/* Rooted tree functions */
+LCT lowestCommonAncestor(Forest * t, int r, int u, int v);
+int distance(Forest * t, int u, int v);
+
+/* Statistics functions */
+#ifndef LCT_NO_STATS
+unsigned long now();
+void recordOp(int command, unsigned long ns);
+void mergeStats(Stats * into, Stats * from);
+unsigned long percentile(Histogram * h, double q);
+void printStats(FILE * out);
+#endif
+
+/* Auxiliar funtions */
+void unflip(LCT node);
+void applyAdd(LCT node, long x);
+void pushDown(LCT node);
+void update(LCT node);
+void setValue(Forest * t, int v, long x);
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef BACKEND_H
+#define BACKEND_H
+
+/*
+ * @brief: A dynamic forest that can replace the LCT for the L, C, Q and Z commands. The forest is created with
+ *		   the number of nodes and every function receives it first, the nodes are numbered from 0.
+ */
+typedef struct
+{
+	const char * name;
+	void* (*create)(int V);
+	void (*destroy)(void * forest);
+	void (*link)(void * forest, int u, int v);
+	void (*cut)(void * forest, int u, int v);
+	int (*connected)(void * forest, int u, int v);
+	int (*size)(void * forest, int v);
+
+} Backend;
+
+#endif
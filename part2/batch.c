@@ -0,0 +1,384 @@
+#define _POSIX_C_SOURCE 200112L /* pthreads */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "batch.h"
+
+/* Phases run by the workers. */
+#define PHASE_TOPS 0
+#define PHASE_RUN 1
+
+/************************************************ SIGNATURES ****************************************************/
+void* workerLoop(void * arg);
+void runPhase(Executor * ex, int phase);
+void findTops(Worker * w);
+void runGroups(Worker * w);
+LCT topNode(LCT node, int * deep);
+void findRoots(Executor * ex);
+int topId(Executor * ex, LCT top);
+int findGroup(Executor * ex, int i);
+void groupOps(Executor * ex);
+
+/*****************************************************************************************************************/
+
+/* @brief: Function that creates the pool of threads.
+ *
+ *		   Receives the number of threads and the number of nodes of the LCT.
+ */
+Executor* createExecutor(int nThreads, int V)
+{
+	Executor * ex = (Executor*) malloc(sizeof(Executor));
+	int i;
+
+	ex->nThreads = nThreads;
+	ex->generation = 0;
+	ex->running = 0;
+	ex->stop = 0;
+	ex->phase = PHASE_TOPS;
+	ex->t = NULL;
+	ex->nOps = 0;
+	ex->window = 0;
+	ex->nGroups = 0;
+	ex->nextGroup = 0;
+
+	ex->ops = (Op*) malloc(sizeof(Op)*BATCH_SIZE);
+	ex->tops = (LCT*) malloc(sizeof(LCT)*2*BATCH_SIZE);
+	ex->parent = (int*) malloc(sizeof(int)*2*BATCH_SIZE);
+	ex->order = (int*) malloc(sizeof(int)*BATCH_SIZE);
+	ex->groupOf = (int*) malloc(sizeof(int)*BATCH_SIZE);
+	ex->groupStart = (int*) malloc(sizeof(int)*(2*BATCH_SIZE + 1));
+	ex->capacity = V;
+	ex->stamp = (int*) calloc(V, sizeof(int));
+	ex->id = (int*) malloc(sizeof(int)*V);
+	STAT(ex->owner = &stats;)
+
+	pthread_mutex_init(&ex->lock, NULL);
+	pthread_cond_init(&ex->start, NULL);
+	pthread_cond_init(&ex->done, NULL);
+
+	ex->workers = (Worker*) malloc(sizeof(Worker)*nThreads);
+	for (i = 0; i < nThreads; i++)
+	{
+		ex->workers[i].ex = ex;
+		ex->workers[i].id = i;
+		ex->workers[i].deep = 0;
+		pthread_create(&ex->workers[i].thread, NULL, workerLoop, &ex->workers[i]);
+	}
+
+	return ex;
+}
+
+/* @brief: Function that stops the threads and frees the pool.
+ *		   Receives the pool.
+ */
+void freeExecutor(Executor * ex)
+{
+	int i;
+
+	pthread_mutex_lock(&ex->lock);
+	ex->stop = 1;
+	pthread_cond_broadcast(&ex->start);
+	pthread_mutex_unlock(&ex->lock);
+
+	for (i = 0; i < ex->nThreads; i++)
+		pthread_join(ex->workers[i].thread, NULL);
+
+	pthread_mutex_destroy(&ex->lock);
+	pthread_cond_destroy(&ex->start);
+	pthread_cond_destroy(&ex->done);
+
+	free(ex->workers);
+	free(ex->ops);
+	free(ex->tops);
+	free(ex->parent);
+	free(ex->order);
+	free(ex->groupOf);
+	free(ex->groupStart);
+	free(ex->stamp);
+	free(ex->id);
+	free(ex);
+}
+
+/* @brief: Function that adds a command to the window.
+ *
+ *		   Receives the pool, the command and its nodes.
+ *		   Returns 1 if the window is full and must be run.
+ */
+int pushOp(Executor * ex, int command, int u, int v)
+{
+	Op * op = &ex->ops[ex->nOps++];
+
+	op->command = command;
+	op->u = u;
+	op->v = v;
+
+	return ex->nOps == BATCH_SIZE;
+}
+
+/* @brief: Function that runs the commands of the window and writes the answers of the queries in order.
+ *
+ *		   Receives the pool, the forest with all LCT nodes and where the answers are written.
+ */
+void runBatch(Executor * ex, Forest * t, Writer * out)
+{
+	int i;
+
+	if (ex->nOps == 0)
+		return;
+
+	if (t->size > ex->capacity)
+	{
+		ex->stamp = (int*) realloc(ex->stamp, sizeof(int)*t->size);
+		ex->id = (int*) realloc(ex->id, sizeof(int)*t->size);
+		memset(ex->stamp + ex->capacity, 0, sizeof(int)*(t->size - ex->capacity));
+		ex->capacity = t->size;
+	}
+
+	ex->t = t;
+	/* the top nodes are only read, so every worker finds the ones of a slice of the window */
+	runPhase(ex, PHASE_TOPS);
+	for (i = 0; i < ex->nThreads && !ex->workers[i].deep; i++)
+		;
+	if (i < ex->nThreads)
+		findRoots(ex);
+	groupOps(ex);
+	runPhase(ex, PHASE_RUN);
+
+	for (i = 0; i < ex->nOps; i++)
+		if (ex->ops[i].command == 'Q')
+		{
+			writeChar(out, ex->ops[i].answer ? 'T' : 'F');
+			writeChar(out, '\n');
+		}
+
+	ex->nOps = 0;
+}
+
+/* @brief: Function that starts every worker in a phase and waits until all of them are done.
+ *		   Receives the pool and the phase.
+ */
+void runPhase(Executor * ex, int phase)
+{
+	pthread_mutex_lock(&ex->lock);
+	ex->phase = phase;
+	ex->running = ex->nThreads;
+	ex->generation++;
+	pthread_cond_broadcast(&ex->start);
+	while (ex->running > 0)
+		pthread_cond_wait(&ex->done, &ex->lock);
+	pthread_mutex_unlock(&ex->lock);
+}
+
+/* @brief: Function run by every thread of the pool, it waits for a phase, runs its part and reports that it is
+ *		   done.
+ *
+ *		   Receives the worker.
+ */
+void* workerLoop(void * arg)
+{
+	Worker * w = (Worker*) arg;
+	Executor * ex = w->ex;
+	int seen = 0;
+
+	while (1)
+	{
+		pthread_mutex_lock(&ex->lock);
+		while (ex->generation == seen && !ex->stop)
+			pthread_cond_wait(&ex->start, &ex->lock);
+		if (ex->stop)
+		{
+			pthread_mutex_unlock(&ex->lock);
+			break;
+		}
+		seen = ex->generation;
+		pthread_mutex_unlock(&ex->lock);
+
+		if (ex->phase == PHASE_TOPS)
+			findTops(w);
+		else
+			runGroups(w);
+
+		pthread_mutex_lock(&ex->lock);
+		STAT(mergeStats(ex->owner, &stats);)
+		STAT(memset(&stats, 0, sizeof(Stats));)
+		if (--ex->running == 0)
+			pthread_cond_signal(&ex->done);
+		pthread_mutex_unlock(&ex->lock);
+	}
+
+	return NULL;
+}
+
+/* @brief: Function that gives the top node of the tree of a node, the only node of its tree without a hook. It
+ *		   follows the hooks without changing anything so several threads can do it at the same time.
+ *
+ *		   Receives the node and where it is marked that the walk was stopped.
+ *		   Returns the top node or NULL if it is more than MAX_WALK hooks away.
+ */
+LCT topNode(LCT node, int * deep)
+{
+	int steps;
+
+	for (steps = 0; node->hook != NULL; steps++)
+	{
+		if (steps == MAX_WALK)
+		{
+			*deep = 1;
+			return NULL;
+		}
+		node = node->hook;
+	}
+	return node;
+}
+
+/* @brief: Function that finds the top nodes of the ends of the commands in the slice of the window of a worker,
+ *		   it stops at the first one that is too far since the window will be grouped by roots.
+ *
+ *		   Receives the worker.
+ */
+void findTops(Worker * w)
+{
+	Executor * ex = w->ex;
+	int i, first = (int)((long)ex->nOps * w->id / ex->nThreads);
+	int last = (int)((long)ex->nOps * (w->id + 1) / ex->nThreads);
+
+	w->deep = 0;
+	for (i = first; i < last && !w->deep; i++)
+	{
+		ex->tops[2*i] = topNode(NODE(ex->t, ex->ops[i].u), &w->deep);
+		ex->tops[2*i + 1] = topNode(NODE(ex->t, ex->ops[i].v), &w->deep);
+	}
+}
+
+/* @brief: Function that gives the root of the tree of each end of the commands of the window, in place of the top
+ *		   nodes. findRoot splays, so it is run by the thread that owns the pool before the groups are made.
+ *
+ *		   Receives the pool.
+ */
+void findRoots(Executor * ex)
+{
+	int i;
+
+	for (i = 0; i < ex->nOps; i++)
+	{
+		ex->tops[2*i] = findRoot(ex->t, ex->ops[i].u);
+		ex->tops[2*i + 1] = findRoot(ex->t, ex->ops[i].v);
+	}
+}
+
+/* @brief: Function that gives the union find id of a top node, creating it the first time the node is seen in
+ *		   this window.
+ *
+ *		   Receives the pool and the top node.
+ */
+int topId(Executor * ex, LCT top)
+{
+	int node = top->id;
+
+	if (ex->stamp[node] != ex->window)
+	{
+		ex->stamp[node] = ex->window;
+		ex->id[node] = ex->nGroups;
+		ex->parent[ex->nGroups] = ex->nGroups;
+		ex->nGroups++;
+	}
+
+	return ex->id[node];
+}
+
+/* @brief: Function that finds the representative of an id in the union find, halving the path.
+ *		   Receives the pool and the id.
+ */
+int findGroup(Executor * ex, int i)
+{
+	while (ex->parent[i] != i)
+	{
+		ex->parent[i] = ex->parent[ex->parent[i]];
+		i = ex->parent[i];
+	}
+	return i;
+}
+
+/* @brief: Function that splits the window in groups that can run at the same time. The trees of the two ends of
+ *		   a command are joined in the union find and the commands are then sorted by group with a counting sort,
+ *		   which keeps the order of the trace inside each group.
+ *
+ *		   Receives the pool.
+ */
+void groupOps(Executor * ex)
+{
+	int i, a, b, nIds;
+
+	ex->window++;
+	ex->nGroups = 0;
+	for (i = 0; i < ex->nOps; i++)
+	{
+		a = findGroup(ex, topId(ex, ex->tops[2*i]));
+		b = findGroup(ex, topId(ex, ex->tops[2*i + 1]));
+		if (a != b)
+			ex->parent[a] = b;
+	}
+	nIds = ex->nGroups;
+
+	memset(ex->groupStart, 0, sizeof(int)*(nIds + 1));
+	for (i = 0; i < ex->nOps; i++)
+	{
+		ex->groupOf[i] = findGroup(ex, ex->id[ex->tops[2*i]->id]);
+		ex->groupStart[ex->groupOf[i] + 1]++;
+	}
+	for (i = 0; i < nIds; i++)
+		ex->groupStart[i + 1] += ex->groupStart[i];
+
+	/* the union find is no longer needed, parent holds the next free position of each group */
+	for (i = 0; i < nIds; i++)
+		ex->parent[i] = ex->groupStart[i];
+	for (i = 0; i < ex->nOps; i++)
+		ex->order[ex->parent[ex->groupOf[i]]++] = i;
+
+	ex->nextGroup = 0;
+}
+
+/* @brief: Function where a worker claims groups of the window and runs their commands in order, until there are
+ *		   no groups left. Empty groups (ids that stopped being representatives) are skipped.
+ *
+ *		   Receives the worker.
+ */
+void runGroups(Worker * w)
+{
+	Executor * ex = w->ex;
+	Op * op;
+	int g, i;
+	STAT(unsigned long begin;)
+
+	while (1)
+	{
+		pthread_mutex_lock(&ex->lock);
+		while (ex->nextGroup < ex->nGroups && ex->groupStart[ex->nextGroup] == ex->groupStart[ex->nextGroup + 1])
+			ex->nextGroup++;
+		g = ex->nextGroup++;
+		pthread_mutex_unlock(&ex->lock);
+
+		if (g >= ex->nGroups)
+			break;
+
+		for (i = ex->groupStart[g]; i < ex->groupStart[g + 1]; i++)
+		{
+			op = &ex->ops[ex->order[i]];
+			STAT(begin = now();)
+			switch (op->command)
+			{
+				case 'L':
+					link(ex->t, op->u, op->v);
+					break;
+				case 'C':
+					cut(ex->t, op->u, op->v);
+					break;
+				case 'Q':
+					op->answer = connectedQ(ex->t, op->u, op->v);
+					break;
+			}
+			STAT(recordOp(op->command, now() - begin);)
+		}
+	}
+}
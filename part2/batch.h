@@ -0,0 +1,104 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <pthread.h>
+
+#include "io.h"
+#include "LCT.h"
+
+/************************************************** NOTE ********************************************************/
+/*  The batch executor runs windows of L, C and Q commands over a pool of threads. Commands whose nodes are in   */
+/*  different trees never touch the same LCT nodes, so the window is split in groups: two commands are in the   */
+/*  same group if they touch the same tree at the begining of the window or if a link of the window joins their */
+/*  trees. Each group runs in order in one thread and the answers are written in the order of the trace, so the */
+/*  output is the same as the sequential one. A tree is found by following hooks to its top node, which is as  */
+/*  long as the tree after a run of links, so a walk stops after MAX_WALK hooks and then the trees of the whole */
+/*  window are found with findRoot by the thread that owns the pool, in amortized O(log n) each.                */
+/****************************************************************************************************************/
+
+/* Number of commands in a window. */
+#define BATCH_SIZE 16384
+
+/* Most hooks followed to find the top node of a tree. */
+#define MAX_WALK 64
+
+/*
+ * @brief: A command of the window and, for queries, its answer.
+ */
+typedef struct
+{
+	int command;
+	int u;
+	int v;
+	int answer;
+
+} Op;
+
+typedef struct Executor Executor;
+
+/*
+ * @brief: A thread of the pool.
+ */
+typedef struct
+{
+	Executor * ex;
+	int id;
+	pthread_t thread;
+	/* a walk of the last window stopped after MAX_WALK hooks */
+	int deep;
+
+} Worker;
+
+/*
+ * @brief: Pool of threads and the window of commands they run.
+ */
+struct Executor
+{
+	int nThreads;
+	Worker * workers;
+	pthread_mutex_t lock;
+	pthread_cond_t start;
+	pthread_cond_t done;
+	/* incremented every time the workers are started */
+	int generation;
+	/* workers that did not finish the current phase */
+	int running;
+	int stop;
+	int phase;
+
+	/* the window */
+	Forest * t;
+	Op * ops;
+	int nOps;
+
+	/* node that stands for the tree of each end of each command, the top node found by the workers in the first
+	   phase or the root found by findRoot */
+	LCT * tops;
+	/* union find over the top nodes, a top node gets an id the first time it is seen in a window */
+	int * stamp;
+	int * id;
+	/* nodes that stamp and id can hold, they grow with the forest */
+	int capacity;
+	int * parent;
+	int window;
+
+	/* group of each command, the commands of the window sorted by group and the first command of each group */
+	int * groupOf;
+	int * order;
+	int * groupStart;
+	int nGroups;
+	/* next group to be claimed by a worker */
+	int nextGroup;
+
+#ifndef LCT_NO_STATS
+	/* statistics of the thread that owns the executor, where the workers merge theirs */
+	Stats * owner;
+#endif
+};
+
+Executor* createExecutor(int nThreads, int V);
+void freeExecutor(Executor * ex);
+int pushOp(Executor * ex, int command, int u, int v);
+void runBatch(Executor * ex, Forest * t, Writer * out);
+
+#endif
@@ -0,0 +1,134 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Files where the statistics of ./test and the profiles of ./workload are written. */
+#define STATS_FILE "bench.stats"
+#define PROFILES_FILE "bench.profiles"
+
+/* Most profiles and longest name of a profile read from ./workload. */
+#define MAX_PROFILES 64
+#define MAX_NAME 64
+
+/************************************************ SIGNATURES ****************************************************/
+int readProfiles(char profiles[MAX_PROFILES][MAX_NAME]);
+int runOne(const char * profile, long ops, long nodes, const char * mix, const char * seed, const char * options);
+
+/*****************************************************************************************************************/
+
+/* @brief: ./bench [-m L,C,Q] [-s seed] [-t "options of ./test"] [ops ...]
+ *		   Runs every profile listed by ./workload -l with each number of operations (10^5, 10^6 and 10^7 by
+ *		   default) on ./test, with a tenth as many nodes, and prints the commands per second and the rotations
+ *		   per command given by the statistics of ./test. Both programs must be in the current directory and ./test must be
+ *		   compiled without -DLCT_NO_STATS.
+ *         EX: ./bench 100000000 -> one run of 10^8 operations for every profile.
+ */
+int main(int argc, char * argv[])
+{
+	const char * mix = "40,10,50", * seed = "1", * options = "";
+	long * ops = (long*) malloc(sizeof(long)*(argc + 3));
+	char profiles[MAX_PROFILES][MAX_NAME];
+	int nOps = 0, nProfiles, i, p;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+			mix = argv[++i];
+		else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+			seed = argv[++i];
+		else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+			options = argv[++i];
+		else if ((ops[nOps] = atol(argv[i])) > 0)
+			nOps++;
+		else
+		{
+			fprintf(stderr, "ERROR: Unknown option %s\n", argv[i]);
+			free(ops);
+			return EXIT_FAILURE;
+		}
+	}
+
+	if (nOps == 0)
+	{
+		ops[nOps++] = 100000L;
+		ops[nOps++] = 1000000L;
+		ops[nOps++] = 10000000L;
+	}
+
+	if ((nProfiles = readProfiles(profiles)) == 0)
+	{
+		fprintf(stderr, "ERROR: Can not list the profiles of ./workload\n");
+		free(ops);
+		return EXIT_FAILURE;
+	}
+
+	printf("%-12s %12s %10s %14s %14s\n", "profile", "ops", "nodes", "ops/s", "rotations/op");
+	for (i = 0; i < nOps; i++)
+		for (p = 0; p < nProfiles; p++)
+			if (!runOne(profiles[p], ops[i], (ops[i] / 10 > 2) ? ops[i] / 10 : 2, mix, seed, options))
+			{
+				fprintf(stderr, "ERROR: The run of %s with %ld operations failed\n", profiles[p], ops[i]);
+				free(ops);
+				return EXIT_FAILURE;
+			}
+
+	remove(STATS_FILE);
+	free(ops);
+	return EXIT_SUCCESS;
+}
+
+/* @brief: Function that asks ./workload for its profiles, so that new ones are benchmarked without changes here.
+ *
+ *		   Receives where the names are stored.
+ *		   Returns the number of profiles, 0 if ./workload could not be run.
+ */
+int readProfiles(char profiles[MAX_PROFILES][MAX_NAME])
+{
+	FILE * file;
+	int n = 0;
+
+	if (system("./workload -l > " PROFILES_FILE) != 0 || (file = fopen(PROFILES_FILE, "r")) == NULL)
+		return 0;
+
+	while (n < MAX_PROFILES && fscanf(file, "%63s", profiles[n]) == 1)
+		n++;
+	fclose(file);
+	remove(PROFILES_FILE);
+
+	return n;
+}
+
+/* @brief: Function that runs one workload through ./test and prints its line of the table.
+ *
+ *		   Receives the profile, the number of operations and of nodes, the mix, the seed and the options of ./test.
+ *		   Returns 1 if the statistics were read.
+ */
+int runOne(const char * profile, long ops, long nodes, const char * mix, const char * seed, const char * options)
+{
+	char command[512], line[256];
+	unsigned long count = 0, rotations = 0;
+	double seconds = 0, perSecond = 0, perCommand = 0;
+	int found = 0;
+	FILE * file;
+
+	sprintf(command, "./workload %s %ld %ld -s %.20s -m %.20s -b | ./test %.200s > /dev/null 2> %s", profile, nodes,
+		ops, seed, mix, options, STATS_FILE);
+	if (system(command) != 0 || (file = fopen(STATS_FILE, "r")) == NULL)
+		return 0;
+
+	while (fgets(line, sizeof(line), file) != NULL)
+	{
+		if (sscanf(line, "commands: %lu in %lf s (%lf per second)", &count, &seconds, &perSecond) == 3)
+			found++;
+		else if (sscanf(line, "rotations: %lu (%lf per command)", &rotations, &perCommand) == 2)
+			found++;
+	}
+	fclose(file);
+
+	if (found < 2)
+		return 0;
+
+	printf("%-12s %12ld %10ld %14.0f %14.2f\n", profile, ops, nodes, perSecond, perCommand);
+	fflush(stdout);
+	return 1;
+}
@@ -0,0 +1,414 @@
+#include <stdlib.h>
+
+#include "ett.h"
+#include "pairs.h"
+#include "xorshift.h"
+
+/************************************************ SIGNATURES ****************************************************/
+/* Treap functions */
+void ettUpdate(EttNode node);
+EttNode ettMerge(EttNode a, EttNode b);
+void ettSplit(EttNode t, int k, EttNode * a, EttNode * b);
+int ettIndex(EttNode node);
+void ettReset(ETT * f, EttNode node, int u, int v);
+
+/* Edge table functions */
+unsigned long pairSlot(ETT * f, int u, int v);
+unsigned long pairHome(void * forest, int k);
+
+/* Backend functions */
+void* ettBackendCreate(int V);
+void ettBackendDestroy(void * forest);
+void ettBackendLink(void * forest, int u, int v);
+void ettBackendCut(void * forest, int u, int v);
+int ettBackendConnected(void * forest, int u, int v);
+int ettBackendSize(void * forest, int v);
+
+/*****************************************************************************************************************/
+
+Backend ettBackend = { "ett", ettBackendCreate, ettBackendDestroy, ettBackendLink, ettBackendCut,
+	ettBackendConnected, ettBackendSize };
+
+/* @brief: Function to allocate a forest of V vertices without edges.
+ *		   Receives an integer which defines the number of vertices.
+ */
+ETT* createEtt(int V)
+{
+	ETT * f = (ETT*) malloc(sizeof(ETT));
+	int i, pairs = (V > 1) ? V - 1 : 1;
+
+	f->V = V;
+	f->seed = 2463534242UL;
+	f->vertices = (EttNode) malloc(sizeof(struct EttNode)*V);
+	f->edges = (EttNode) malloc(sizeof(struct EttNode)*2*pairs);
+	f->freeEdges = (int*) malloc(sizeof(int)*pairs);
+	f->nFree = 0;
+
+	for (i = 0; i < V; i++)
+		ettReset(f, &f->vertices[i], i, i);
+	for (i = pairs - 1; i >= 0; i--)
+		f->freeEdges[f->nFree++] = i;
+
+	/* at least twice as many slots as edges */
+	for (f->mask = 1; f->mask < 2UL*pairs + 2; f->mask <<= 1)
+		;
+	f->table = (int*) malloc(sizeof(int)*f->mask);
+	for (i = 0; i < (int)f->mask; i++)
+		f->table[i] = -1;
+	f->mask--;
+
+	return f;
+}
+
+/* @brief: Function to free the memory of a forest.
+ *		   Receives a pointer to the forest.
+ */
+void freeEtt(ETT * f)
+{
+	free(f->vertices);
+	free(f->edges);
+	free(f->freeEdges);
+	free(f->table);
+	free(f);
+}
+
+/* @brief: Function that turns a node into a treap of its own, with a new random priority (xorshift).
+ *
+ *		   Receives the forest, the node and the vertices of the node.
+ */
+void ettReset(ETT * f, EttNode node, int u, int v)
+{
+	node->left = node->right = node->parent = NULL;
+	node->priority = xorshift(&f->seed);
+	node->mark = 0;
+	node->u = u;
+	node->v = v;
+	ettUpdate(node);
+}
+
+/* @brief: Function that recomputes the sizes of a node from its children.
+ *		   Receives the node.
+ */
+void ettUpdate(EttNode node)
+{
+	node->size = 1;
+	node->vertices = (node->u == node->v);
+	node->marks = node->mark;
+
+	if (node->left != NULL)
+	{
+		node->size += node->left->size;
+		node->vertices += node->left->vertices;
+		node->marks |= node->left->marks;
+	}
+	if (node->right != NULL)
+	{
+		node->size += node->right->size;
+		node->vertices += node->right->vertices;
+		node->marks |= node->right->marks;
+	}
+}
+
+/* @brief: Function that concatenates two treaps, the one with the higher priority root stays on top.
+ *
+ *		   Receives the two treaps, all nodes of a come before the ones of b.
+ *		   Returns the root of the result.
+ */
+EttNode ettMerge(EttNode a, EttNode b)
+{
+	if (a == NULL)
+		return b;
+	if (b == NULL)
+		return a;
+
+	if (a->priority > b->priority)
+	{
+		a->right = ettMerge(a->right, b);
+		a->right->parent = a;
+		ettUpdate(a);
+		a->parent = NULL;
+		return a;
+	}
+
+	b->left = ettMerge(a, b->left);
+	b->left->parent = b;
+	ettUpdate(b);
+	b->parent = NULL;
+	return b;
+}
+
+/* @brief: Function that splits a treap in its first k nodes and the rest.
+ *
+ *		   Receives the treap, k and where the roots of the two parts are stored.
+ */
+void ettSplit(EttNode t, int k, EttNode * a, EttNode * b)
+{
+	int leftSize;
+
+	if (t == NULL)
+	{
+		*a = *b = NULL;
+		return;
+	}
+
+	leftSize = (t->left != NULL) ? t->left->size : 0;
+	if (k <= leftSize)
+	{
+		ettSplit(t->left, k, a, &t->left);
+		if (t->left != NULL)
+			t->left->parent = t;
+		*b = t;
+	}
+	else
+	{
+		ettSplit(t->right, k - leftSize - 1, &t->right, b);
+		if (t->right != NULL)
+			t->right->parent = t;
+		*a = t;
+	}
+	ettUpdate(t);
+	t->parent = NULL;
+}
+
+/* @brief: Function that finds the root of the treap of a node.
+ *		   Receives the node.
+ */
+EttNode ettRoot(EttNode node)
+{
+	while (node->parent != NULL)
+		node = node->parent;
+	return node;
+}
+
+/* @brief: Function that finds the position of a node in its Euler tour.
+ *		   Receives the node.
+ */
+int ettIndex(EttNode node)
+{
+	int index = (node->left != NULL) ? node->left->size : 0;
+
+	for (; node->parent != NULL; node = node->parent)
+		if (node == node->parent->right)
+			index += 1 + ((node->parent->left != NULL) ? node->parent->left->size : 0);
+
+	return index;
+}
+
+/* @brief: Function that makes v the first node of the Euler tour of its tree, by rotating the tour.
+ *
+ *		   Receives the forest and the vertex.
+ */
+void ettReroot(ETT * f, int v)
+{
+	EttNode node = &f->vertices[v], a, b;
+
+	ettSplit(ettRoot(node), ettIndex(node), &a, &b);
+	ettMerge(b, a);
+}
+
+/* @brief: Function that checks if u and v are in the same tree.
+ *
+ *		   Receives the forest, int u and int v.
+ */
+int ettConnected(ETT * f, int u, int v)
+{
+	return u == v || ettRoot(&f->vertices[u]) == ettRoot(&f->vertices[v]);
+}
+
+/* @brief: Function that computes the number of vertices in the tree of v.
+ *
+ *		   Receives the forest and the vertex.
+ */
+int ettSize(ETT * f, int v)
+{
+	return ettRoot(&f->vertices[v])->vertices;
+}
+
+/* @brief: Adds the edge (u, v), the tour of v's tree is placed after u between the two nodes of the edge. Nothing
+ *		   is done if u and v are already connected.
+ *
+ *		   Receives the forest, int u and int v.
+ *		   Returns 1 if the edge was added.
+ */
+int ettLink(ETT * f, int u, int v)
+{
+	EttNode uv, vu, a, b;
+	unsigned long slot;
+	int k;
+
+	if (ettConnected(f, u, v) || f->nFree == 0)
+		return 0;
+
+	k = f->freeEdges[--f->nFree];
+	slot = pairSlot(f, u, v);
+	f->table[slot] = k;
+
+	uv = &f->edges[2*k + (u > v)];
+	vu = &f->edges[2*k + (u < v)];
+	ettReset(f, uv, u, v);
+	ettReset(f, vu, v, u);
+
+	ettReroot(f, u);
+	ettReroot(f, v);
+	a = ettRoot(&f->vertices[u]);
+	b = ettRoot(&f->vertices[v]);
+	ettMerge(ettMerge(ettMerge(a, uv), b), vu);
+
+	return 1;
+}
+
+/* @brief: Removes the edge (u, v). The tour is A uv B vu C (or the same with uv and vu switched), B is the tour
+ *		   of the tree that leaves and A C the one of the tree that stays.
+ *
+ *		   Receives the forest, int u and int v.
+ *		   Returns 1 if the edge existed.
+ */
+int ettCut(ETT * f, int u, int v)
+{
+	EttNode first, a, b, c, rest, aux;
+	unsigned long slot = pairSlot(f, u, v);
+	int k = f->table[slot], i, j;
+
+	if (k == -1)
+		return 0;
+
+	/* i and j are the positions of the two nodes of the edge, i < j */
+	first = &f->edges[2*k];
+	i = ettIndex(first);
+	j = ettIndex(&f->edges[2*k + 1]);
+	if (i > j)
+	{
+		first = &f->edges[2*k + 1];
+		i = j;
+		j = ettIndex(&f->edges[2*k]);
+	}
+
+	ettSplit(ettRoot(first), i, &a, &rest);
+	ettSplit(rest, 1, &aux, &rest);
+	ettSplit(rest, j - i - 1, &b, &rest);
+	ettSplit(rest, 1, &aux, &c);
+	ettMerge(a, c);
+
+	f->freeEdges[f->nFree++] = k;
+	removePairSlot(f->table, f->mask, slot, pairHome, f);
+
+	return 1;
+}
+
+/* @brief: Function that checks if the edge (u, v) is in the forest.
+ *
+ *		   Receives the forest, int u and int v.
+ */
+int ettHasEdge(ETT * f, int u, int v)
+{
+	return f->table[pairSlot(f, u, v)] != -1;
+}
+
+/* @brief: Function that gives the node min(u, v)->max(u, v) of the edge (u, v), or NULL if there is no such edge.
+ *
+ *		   Receives the forest, int u and int v.
+ */
+EttNode ettEdge(ETT * f, int u, int v)
+{
+	int k = f->table[pairSlot(f, u, v)];
+
+	return (k == -1) ? NULL : &f->edges[2*k];
+}
+
+/* @brief: Function that sets (on = 1) or clears (on = 0) bits of the mark of a node, the or of the marks is fixed
+ *		   up to the root of its treap.
+ *
+ *		   Receives the node, the bits and on.
+ */
+void ettMark(EttNode node, int bits, int on)
+{
+	node->mark = on ? (node->mark | bits) : (node->mark & ~bits);
+	for (; node != NULL; node = node->parent)
+		ettUpdate(node);
+}
+
+/* @brief: Function that finds a node of a treap whose mark has one of the bits, following the or of the marks
+ *		   down from the root.
+ *
+ *		   Receives the root of the treap and the bits.
+ *		   Returns the node or NULL if there is none.
+ */
+EttNode ettFindMark(EttNode root, int bits)
+{
+	EttNode node = root;
+
+	while (node != NULL && !(node->mark & bits))
+	{
+		if (node->left != NULL && (node->left->marks & bits))
+			node = node->left;
+		else if (node->right != NULL && (node->right->marks & bits))
+			node = node->right;
+		else
+			return NULL;
+	}
+
+	return node;
+}
+
+/* @brief: Function that finds the slot of the edge (u, v) in the hash table, or the empty slot where it would go.
+ *
+ *		   Receives the forest, int u and int v.
+ */
+unsigned long pairSlot(ETT * f, int u, int v)
+{
+	int a = (u < v) ? u : v, b = (u < v) ? v : u;
+	unsigned long slot;
+	EttNode e;
+
+	for (slot = pairHash(a, b) & f->mask; f->table[slot] != -1; slot = (slot + 1) & f->mask)
+	{
+		e = &f->edges[2*f->table[slot]];
+		if (e->u == a && e->v == b)
+			break;
+	}
+
+	return slot;
+}
+
+/* @brief: Function that gives the home slot of the k-th pair in the hash table, for removePairSlot.
+ *
+ *		   Receives the forest and the index of the pair.
+ */
+unsigned long pairHome(void * forest, int k)
+{
+	ETT * f = (ETT*) forest;
+
+	return pairHash(f->edges[2*k].u, f->edges[2*k].v) & f->mask;
+}
+
+/* @brief: Functions that adapt the Euler tour trees to the backend interface.
+ */
+void* ettBackendCreate(int V)
+{
+	return createEtt(V);
+}
+
+void ettBackendDestroy(void * forest)
+{
+	freeEtt((ETT*) forest);
+}
+
+void ettBackendLink(void * forest, int u, int v)
+{
+	ettLink((ETT*) forest, u, v);
+}
+
+void ettBackendCut(void * forest, int u, int v)
+{
+	ettCut((ETT*) forest, u, v);
+}
+
+int ettBackendConnected(void * forest, int u, int v)
+{
+	return ettConnected((ETT*) forest, u, v);
+}
+
+int ettBackendSize(void * forest, int v)
+{
+	return ettSize((ETT*) forest, v);
+}
@@ -0,0 +1,67 @@
+#ifndef ETT_H
+#define ETT_H
+
+#include "backend.h"
+
+/************************************************** NOTE ********************************************************/
+/*  Euler tour trees. Each tree of the forest is kept as its Euler tour, a cyclic sequence with one node for    */
+/*  every vertex and two for every edge (u->v and v->u), stored in a treap ordered by position. Rerooting is a  */
+/*  rotation of the sequence, link and cut are a few splits and merges, and two vertices are connected if their */
+/*  nodes are in the same treap, which is found by following parent pointers and changes nothing.              */
+/****************************************************************************************************************/
+
+typedef struct EttNode *EttNode;
+
+/* Represents a node of the Euler tour, a vertex when u == v and the edge u->v otherwise. */
+struct EttNode {
+	EttNode left;
+	EttNode right;
+	EttNode parent;
+	/* Heap priority of the treap. */
+	unsigned long priority;
+	/* Number of nodes and of vertex nodes in this sub-tree. */
+	int size;
+	int vertices;
+	/* Bits set by the user of the forest on this node and their or over the sub-tree. */
+	int mark;
+	int marks;
+	int u;
+	int v;
+};
+
+/*
+ * @brief: Forest of Euler tour trees over V vertices. The edge nodes come in pairs, edges[2k] is u->v and
+ *		   edges[2k+1] is v->u with u < v, and a hash table with linear probing maps each pair of vertices to the
+ *		   pair of nodes of its edge.
+ */
+typedef struct
+{
+	int V;
+	EttNode vertices;
+	EttNode edges;
+	/* stack of free edge pairs */
+	int * freeEdges;
+	int nFree;
+	/* pair index of each slot or -1, the table has mask+1 slots */
+	int * table;
+	unsigned long mask;
+	unsigned long seed;
+
+} ETT;
+
+ETT* createEtt(int V);
+void freeEtt(ETT * f);
+int ettLink(ETT * f, int u, int v);
+int ettCut(ETT * f, int u, int v);
+int ettConnected(ETT * f, int u, int v);
+int ettSize(ETT * f, int v);
+int ettHasEdge(ETT * f, int u, int v);
+EttNode ettEdge(ETT * f, int u, int v);
+void ettMark(EttNode node, int bits, int on);
+EttNode ettFindMark(EttNode root, int bits);
+void ettReroot(ETT * f, int v);
+EttNode ettRoot(EttNode node);
+
+extern Backend ettBackend;
+
+#endif
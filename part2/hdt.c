@@ -0,0 +1,455 @@
+#include <stdlib.h>
+
+#include "hdt.h"
+#include "pairs.h"
+
+/* True if v is a vertex of the graph, the others are ignored since every level indexes its vertices directly. */
+#define IS_VERTEX(h, v) ((v) >= 0 && (v) < (h)->V)
+
+/************************************************ SIGNATURES ****************************************************/
+/* Level functions */
+HdtLevel* hdtLevel(HDT * h, int i);
+void addNonTree(HDT * h, int e);
+void removeNonTree(HDT * h, int e);
+void linkTree(HDT * h, int e);
+void raiseTreeEdges(HDT * h, int i, EttNode root);
+int findReplacement(HDT * h, int i, EttNode root);
+
+/* Edge functions */
+int newEdge(HDT * h);
+int endSide(HdtEdge * e, int x);
+unsigned long edgeSlot(HDT * h, int u, int v);
+unsigned long edgeHome(void * graph, int k);
+void growTable(HDT * h);
+
+/* Backend functions */
+void* hdtBackendCreate(int V);
+void hdtBackendDestroy(void * forest);
+void hdtBackendLink(void * forest, int u, int v);
+void hdtBackendCut(void * forest, int u, int v);
+int hdtBackendConnected(void * forest, int u, int v);
+int hdtBackendSize(void * forest, int v);
+
+/*****************************************************************************************************************/
+
+Backend hdtBackend = { "hdt", hdtBackendCreate, hdtBackendDestroy, hdtBackendLink, hdtBackendCut,
+	hdtBackendConnected, hdtBackendSize };
+
+/* @brief: Function to allocate a graph of V vertices without edges. Only the level 0 is created, the others
+ *		   when an edge reaches them.
+ *
+ *		   Receives an integer which defines the number of vertices.
+ */
+HDT* createHdt(int V)
+{
+	HDT * h = (HDT*) malloc(sizeof(HDT));
+	int i;
+
+	/* an edge of level i is in a tree of at most V / 2^i vertices, so there are floor(log2 V) + 1 levels */
+	for (h->nLevels = 1; (1L << h->nLevels) <= V; h->nLevels++)
+		;
+
+	h->V = V;
+	h->levels = (HdtLevel*) malloc(sizeof(HdtLevel)*h->nLevels);
+	for (i = 0; i < h->nLevels; i++)
+	{
+		h->levels[i].forest = NULL;
+		h->levels[i].head = NULL;
+	}
+	hdtLevel(h, 0);
+
+	h->capacity = 16;
+	h->nEdges = 0;
+	h->nFree = 0;
+	h->edges = (HdtEdge*) malloc(sizeof(HdtEdge)*h->capacity);
+	h->freeEdges = (int*) malloc(sizeof(int)*h->capacity);
+
+	h->mask = 2*h->capacity - 1;
+	h->table = (int*) malloc(sizeof(int)*(h->mask + 1));
+	for (i = 0; i <= (int)h->mask; i++)
+		h->table[i] = -1;
+
+	return h;
+}
+
+/* @brief: Function to free the memory of a graph.
+ *		   Receives a pointer to the graph.
+ */
+void freeHdt(HDT * h)
+{
+	int i;
+
+	for (i = 0; i < h->nLevels; i++)
+		if (h->levels[i].forest != NULL)
+		{
+			freeEtt(h->levels[i].forest);
+			free(h->levels[i].head);
+		}
+	free(h->levels);
+	free(h->edges);
+	free(h->freeEdges);
+	free(h->table);
+	free(h);
+}
+
+/* @brief: Function that gives a level, creating its forest and lists the first time.
+ *
+ *		   Receives the graph and the level.
+ */
+HdtLevel* hdtLevel(HDT * h, int i)
+{
+	HdtLevel * level = &h->levels[i];
+	int x;
+
+	if (level->forest == NULL)
+	{
+		level->forest = createEtt(h->V);
+		level->head = (int*) malloc(sizeof(int)*h->V);
+		for (x = 0; x < h->V; x++)
+			level->head[x] = -1;
+	}
+
+	return level;
+}
+
+/* @brief: Function that checks if u and v are connected in the graph.
+ *
+ *		   Receives the graph, int u and int v.
+ *		   Returns 0 when u or v is not a vertex.
+ */
+int hdtConnected(HDT * h, int u, int v)
+{
+	if (!IS_VERTEX(h, u) || !IS_VERTEX(h, v))
+		return 0;
+
+	return ettConnected(h->levels[0].forest, u, v);
+}
+
+/* @brief: Function that computes the number of vertices in the component of v.
+ *
+ *		   Receives the graph and the vertex.
+ *		   Returns 0 when v is not a vertex.
+ */
+int hdtSize(HDT * h, int v)
+{
+	if (!IS_VERTEX(h, v))
+		return 0;
+
+	return ettSize(h->levels[0].forest, v);
+}
+
+/* @brief: Adds the edge (u, v) at level 0, as a tree edge if it joins two components and as a non tree edge
+ *		   otherwise. A link of a pair that already has an edge only counts it and a link of u to itself, or of
+ *		   something that is not a vertex, is ignored.
+ *
+ *		   Receives the graph, int u and int v.
+ */
+void hdtLink(HDT * h, int u, int v)
+{
+	unsigned long slot;
+	HdtEdge * e;
+	int k;
+
+	if (u == v || !IS_VERTEX(h, u) || !IS_VERTEX(h, v))
+		return;
+
+	slot = edgeSlot(h, u, v);
+	if (h->table[slot] != -1)
+	{
+		h->edges[h->table[slot]].count++;
+		return;
+	}
+
+	k = newEdge(h);
+	h->table[edgeSlot(h, u, v)] = k; /* the table may have grown */
+
+	e = &h->edges[k];
+	e->end[0] = (u < v) ? u : v;
+	e->end[1] = (u < v) ? v : u;
+	e->level = 0;
+	e->count = 1;
+
+	if (hdtConnected(h, u, v))
+		addNonTree(h, k);
+	else
+		linkTree(h, k);
+}
+
+/* @brief: Removes one edge (u, v). When the last one was a tree edge its tree is split and a replacement is
+ *		   looked for from the level of the edge down to 0. Nothing is done when u or v is not a vertex.
+ *
+ *		   Receives the graph, int u and int v.
+ */
+void hdtCut(HDT * h, int u, int v)
+{
+	unsigned long slot;
+	int k, i, level;
+	HdtEdge * e;
+	ETT * f;
+
+	if (!IS_VERTEX(h, u) || !IS_VERTEX(h, v))
+		return;
+
+	slot = edgeSlot(h, u, v);
+	k = h->table[slot];
+
+	if (k == -1)
+		return;
+
+	e = &h->edges[k];
+	if (--e->count > 0)
+		return;
+
+	removePairSlot(h->table, h->mask, slot, edgeHome, h);
+	h->freeEdges[h->nFree++] = k;
+
+	if (!e->tree)
+	{
+		removeNonTree(h, k);
+		return;
+	}
+
+	level = e->level;
+	for (i = 0; i <= level; i++)
+		ettCut(h->levels[i].forest, u, v);
+
+	for (i = level; i >= 0; i--)
+	{
+		/* the search runs over the smaller of the two trees */
+		f = h->levels[i].forest;
+		if (findReplacement(h, i, ettRoot(&f->vertices[(ettSize(f, u) <= ettSize(f, v)) ? u : v])))
+			return;
+	}
+}
+
+/* @brief: Function that makes an edge a tree edge of its level, it is added to the forests of every level up to
+ *		   its own and marked in the forest of its level.
+ *
+ *		   Receives the graph and the edge.
+ */
+void linkTree(HDT * h, int k)
+{
+	HdtEdge * e = &h->edges[k];
+	int i;
+
+	e->tree = 1;
+	for (i = 0; i <= e->level; i++)
+		ettLink(h->levels[i].forest, e->end[0], e->end[1]);
+	ettMark(ettEdge(h->levels[e->level].forest, e->end[0], e->end[1]), HDT_TREE, 1);
+}
+
+/* @brief: Function that looks for an edge that reconnects the tree of root in the forest of level i. First the
+ *		   tree edges of level i of the tree go up one level, then the non tree edges of level i of its vertices
+ *		   are looked at: an edge that leaves the tree is the replacement and the others go up one level. The
+ *		   tree is the smaller half of a tree of level i, at most V / 2^(i+1) vertices, so level i + 1 exists.
+ *
+ *		   Receives the graph, the level and the root of the treap of the smaller tree.
+ *		   Returns 1 if a replacement was found.
+ */
+int findReplacement(HDT * h, int i, EttNode root)
+{
+	HdtLevel * level = &h->levels[i];
+	EttNode node;
+	HdtEdge * e;
+	int k, x;
+
+	raiseTreeEdges(h, i, root);
+
+	while ((node = ettFindMark(root, HDT_ADJ)) != NULL)
+	{
+		x = node->u;
+		while ((k = level->head[x]) != -1)
+		{
+			e = &h->edges[k];
+			removeNonTree(h, k);
+			if (!ettConnected(level->forest, e->end[0], e->end[1]))
+			{
+				linkTree(h, k);
+				return 1;
+			}
+			e->level++;
+			addNonTree(h, k);
+		}
+	}
+
+	return 0;
+}
+
+/* @brief: Function that moves the tree edges of level i of a tree one level up, so that the tree is in the forest
+ *		   of level i + 1 before its non tree edges are looked at.
+ *
+ *		   Receives the graph, the level and the root of the treap of the tree.
+ */
+void raiseTreeEdges(HDT * h, int i, EttNode root)
+{
+	EttNode node;
+	HdtEdge * e;
+
+	hdtLevel(h, i + 1);
+	while ((node = ettFindMark(root, HDT_TREE)) != NULL)
+	{
+		ettMark(node, HDT_TREE, 0);
+		e = &h->edges[h->table[edgeSlot(h, node->u, node->v)]];
+		e->level = i + 1;
+		ettLink(h->levels[i + 1].forest, e->end[0], e->end[1]);
+		ettMark(ettEdge(h->levels[i + 1].forest, e->end[0], e->end[1]), HDT_TREE, 1);
+	}
+}
+
+/* @brief: Function that adds a non tree edge to the lists of its ends at its level.
+ *
+ *		   Receives the graph and the edge.
+ */
+void addNonTree(HDT * h, int k)
+{
+	HdtEdge * e = &h->edges[k];
+	HdtLevel * level = hdtLevel(h, e->level);
+	int s, x, first;
+
+	e->tree = 0;
+	for (s = 0; s < 2; s++)
+	{
+		x = e->end[s];
+		first = level->head[x];
+		e->next[s] = first;
+		e->prev[s] = -1;
+		if (first != -1)
+			h->edges[first].prev[endSide(&h->edges[first], x)] = k;
+		else
+			ettMark(&level->forest->vertices[x], HDT_ADJ, 1);
+		level->head[x] = k;
+	}
+}
+
+/* @brief: Function that removes a non tree edge from the lists of its ends at its level.
+ *
+ *		   Receives the graph and the edge.
+ */
+void removeNonTree(HDT * h, int k)
+{
+	HdtEdge * e = &h->edges[k];
+	HdtLevel * level = &h->levels[e->level];
+	int s, x;
+
+	for (s = 0; s < 2; s++)
+	{
+		x = e->end[s];
+		if (e->prev[s] != -1)
+			h->edges[e->prev[s]].next[endSide(&h->edges[e->prev[s]], x)] = e->next[s];
+		else
+			level->head[x] = e->next[s];
+		if (e->next[s] != -1)
+			h->edges[e->next[s]].prev[endSide(&h->edges[e->next[s]], x)] = e->prev[s];
+
+		if (level->head[x] == -1)
+			ettMark(&level->forest->vertices[x], HDT_ADJ, 0);
+	}
+}
+
+/* @brief: Function that gives the side of an edge where x is.
+ *		   Receives the edge and the vertex.
+ */
+int endSide(HdtEdge * e, int x)
+{
+	return e->end[1] == x;
+}
+
+/* @brief: Function that gives a free edge, doubling the arrays and the table when they are full.
+ *		   Receives the graph.
+ */
+int newEdge(HDT * h)
+{
+	if (h->nFree > 0)
+		return h->freeEdges[--h->nFree];
+
+	if (h->nEdges == h->capacity)
+	{
+		h->capacity *= 2;
+		h->edges = (HdtEdge*) realloc(h->edges, sizeof(HdtEdge)*h->capacity);
+		h->freeEdges = (int*) realloc(h->freeEdges, sizeof(int)*h->capacity);
+		growTable(h);
+	}
+
+	return h->nEdges++;
+}
+
+/* @brief: Function that doubles the hash table and inserts the edges again.
+ *		   Receives the graph.
+ */
+void growTable(HDT * h)
+{
+	int k;
+
+	free(h->table);
+	h->mask = 2*h->capacity - 1;
+	h->table = (int*) malloc(sizeof(int)*(h->mask + 1));
+	for (k = 0; k <= (int)h->mask; k++)
+		h->table[k] = -1;
+
+	for (k = 0; k < h->nEdges; k++)
+		if (h->edges[k].count > 0)
+			h->table[edgeSlot(h, h->edges[k].end[0], h->edges[k].end[1])] = k;
+}
+
+/* @brief: Function that finds the slot of the edge (u, v) in the hash table, or the empty slot where it would go.
+ *
+ *		   Receives the graph, int u and int v.
+ */
+unsigned long edgeSlot(HDT * h, int u, int v)
+{
+	int a = (u < v) ? u : v, b = (u < v) ? v : u;
+	unsigned long slot;
+	HdtEdge * e;
+
+	for (slot = pairHash(a, b) & h->mask; h->table[slot] != -1; slot = (slot + 1) & h->mask)
+	{
+		e = &h->edges[h->table[slot]];
+		if (e->end[0] == a && e->end[1] == b)
+			break;
+	}
+
+	return slot;
+}
+
+/* @brief: Function that gives the home slot of the k-th edge in the hash table, for removePairSlot.
+ *
+ *		   Receives the graph and the index of the edge.
+ */
+unsigned long edgeHome(void * graph, int k)
+{
+	HDT * h = (HDT*) graph;
+
+	return pairHash(h->edges[k].end[0], h->edges[k].end[1]) & h->mask;
+}
+
+/* @brief: Functions that adapt the graph to the backend interface.
+ */
+void* hdtBackendCreate(int V)
+{
+	return createHdt(V);
+}
+
+void hdtBackendDestroy(void * forest)
+{
+	freeHdt((HDT*) forest);
+}
+
+void hdtBackendLink(void * forest, int u, int v)
+{
+	hdtLink((HDT*) forest, u, v);
+}
+
+void hdtBackendCut(void * forest, int u, int v)
+{
+	hdtCut((HDT*) forest, u, v);
+}
+
+int hdtBackendConnected(void * forest, int u, int v)
+{
+	return hdtConnected((HDT*) forest, u, v);
+}
+
+int hdtBackendSize(void * forest, int v)
+{
+	return hdtSize((HDT*) forest, v);
+}
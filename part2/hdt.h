@@ -0,0 +1,68 @@
+#ifndef HDT_H
+#define HDT_H
+
+#include "ett.h"
+
+/************************************************** NOTE ********************************************************/
+/*  Fully dynamic connectivity of a graph (Holm, de Lichtenberg and Thorup). Every edge has a level, the forest  */
+/*  of level i is a spanning forest of the edges of level >= i kept in Euler tour trees, and the forest of level */
+/*  0 answers the queries. When a tree edge is cut the smaller of the two trees is searched for a replacement,   */
+/*  level by level from the one of the edge, and the edges that are looked at without success go up one level,  */
+/*  which bounds the work of each edge by the number of levels. Parallel edges are counted, not stored twice.   */
+/****************************************************************************************************************/
+
+/* Bits of the marks of the Euler tour nodes. */
+#define HDT_TREE 1 /* edge node of a tree edge of this level */
+#define HDT_ADJ 2  /* vertex node with non tree edges of this level */
+
+/*
+ * @brief: Edge of the graph between end[0] < end[1]. A non tree edge is in the list of both ends at its level,
+ *		   next[s] and prev[s] are its neighbours in the list of end[s].
+ */
+typedef struct
+{
+	int end[2];
+	int level;
+	int tree;
+	/* number of parallel edges, a free edge has count 0 */
+	int count;
+	int next[2];
+	int prev[2];
+
+} HdtEdge;
+
+/* @brief: Spanning forest of a level and the first non tree edge of each vertex, created when first used. */
+typedef struct
+{
+	ETT * forest;
+	int * head;
+
+} HdtLevel;
+
+typedef struct
+{
+	int V;
+	int nLevels;
+	HdtLevel * levels;
+	/* edges of the graph, growing when full, with a stack of free ones */
+	HdtEdge * edges;
+	int nEdges;
+	int capacity;
+	int * freeEdges;
+	int nFree;
+	/* edge of each slot or -1, the table has mask+1 slots and is kept at most half full */
+	int * table;
+	unsigned long mask;
+
+} HDT;
+
+HDT* createHdt(int V);
+void freeHdt(HDT * h);
+void hdtLink(HDT * h, int u, int v);
+void hdtCut(HDT * h, int u, int v);
+int hdtConnected(HDT * h, int u, int v);
+int hdtSize(HDT * h, int v);
+
+extern Backend hdtBackend;
+
+#endif
@@ -3,9 +3,12 @@
 #include <string.h>
 #include <time.h>
 
+void writeWord(FILE * fp, unsigned long x);
+
 /* @brief: This file generates a random LCT struct. The first argument represents the number of nodes we want to 
  *         create, the second one the number of link and cut operations and the third one is the nr of links per
- *		   100 operations. 
+ *		   100 operations. If the fourth argument is "bin" the trace is written in the binary format to input.bin
+ *         (see io.h) instead of input.txt.
  *         EX: ./gen 100000 5000 100 -> creates 100000 nodes and performs 5000 link/cut ops and 100% of this ops 
  *              are links.
  */
@@ -15,19 +18,33 @@ int main(int argc,  char* argv[])
 	int n_nodes = atoi(argv[1]);
 	int n_ops = atoi(argv[2]);
 	int l_percent = atoi(argv[3]);
-	FILE * fp = fopen("input.txt" ,"w+");
+	int binary = (argc > 4 && strcmp(argv[4], "bin") == 0);
+	FILE * fp = binary ? fopen("input.bin", "wb") : fopen("input.txt" ,"w+");
 
 	/* initialize random seed: */
 	srand ( time(NULL) );
 
-	fprintf(fp, "%d\n", n_nodes);
+	if (binary)
+	{
+		fputs("LCTB", fp);
+		writeWord(fp, n_nodes);
+	}
+	else
+		fprintf(fp, "%d\n", n_nodes);
 	while (count < n_ops)
 	{
 		op = rand()%(100+1);
 		n1 = rand()%(n_nodes);
 		while ((n2 = rand()%(n_nodes)) == n1);
 
-		if (op <= l_percent)
+		if (binary)
+		{
+			/* one record is the command byte and two 32 bit little endian node numbers */
+			fputc((op <= l_percent) ? 'L' : 'C', fp);
+			writeWord(fp, n1+1);
+			writeWord(fp, n2+1);
+		}
+		else if (op <= l_percent)
 			fprintf(fp, "%c %d %d\n", 'L', n1+1, n2+1);
 		else
 			fprintf(fp, "%c %d %d\n", 'C', n1+1, n2+1);
@@ -35,6 +52,20 @@ int main(int argc,  char* argv[])
 		count++;
 	}
 
-	fprintf(fp, "X\n");
+	if (binary)
+		fputc('X', fp);
+	else
+		fprintf(fp, "X\n");
 	fclose(fp);
+	return 0;
+}
+
+/* @brief: Writes a 32 bit little endian word.
+ */
+void writeWord(FILE * fp, unsigned long x)
+{
+	int i;
+
+	for (i = 0; i < 4; i++)
+		fputc((int)((x >> (8*i)) & 0xFF), fp);
 }
@@ -0,0 +1,354 @@
+#define _POSIX_C_SOURCE 200112L /* mmap, read, fstat, ftruncate */
+
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "io.h"
+
+/* Size of the blocks read when the input can not be mapped and of the output buffer. */
+#define IN_BLOCK (1 << 20)
+#define OUT_BLOCK (1 << 16)
+
+/* True if there is at least one byte left, reading the next block if needed. */
+#define HAS_DATA(in) ((in)->pos < (in)->len || refill(in))
+
+/************************************************ SIGNATURES ****************************************************/
+int refill(Reader * in);
+int nextByte(Reader * in);
+long readLong(Reader * in);
+unsigned long readWord(Reader * in);
+
+/*****************************************************************************************************************/
+
+/* @brief: Function that opens a trace. Regular files are mapped in memory, pipes and terminals are read in
+ *		   blocks of IN_BLOCK bytes.
+ *
+ *		   Receives the path of the trace or NULL to read the standard input.
+ *		   Returns the reader or NULL if the file can not be opened.
+ */
+Reader* openReader(const char * path)
+{
+	Reader * in;
+	struct stat st;
+	void * map;
+	int fd = 0;
+
+	if (path != NULL && (fd = open(path, O_RDONLY)) < 0)
+		return NULL;
+
+	in = (Reader*) malloc(sizeof(Reader));
+	in->fd = fd;
+	in->pos = 0;
+	in->len = 0;
+	in->block = NULL;
+	in->mapped = 0;
+	in->binary = 0;
+	in->done = 0;
+
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 &&
+		(map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) != MAP_FAILED)
+	{
+		in->buf = (const unsigned char*) map;
+		in->len = st.st_size;
+		in->mapped = 1;
+	}
+	else
+	{
+		in->block = (unsigned char*) malloc(IN_BLOCK);
+		in->buf = in->block;
+	}
+
+	return in;
+}
+
+/* @brief: Function that closes a trace and frees the reader.
+ *		   Receives the reader.
+ */
+void closeReader(Reader * in)
+{
+	if (in->mapped)
+		munmap((void*) in->buf, in->len);
+	free(in->block);
+	if (in->fd != 0)
+		close(in->fd);
+	free(in);
+}
+
+/* @brief: Function that reads the next block of an input that is not mapped. An error other than an interruption
+ *		   ends the input.
+ *
+ *		   Receives the reader.
+ *		   Returns 1 if there is something left to read and 0 otherwise.
+ */
+int refill(Reader * in)
+{
+	ssize_t n;
+
+	if (in->mapped || in->done)
+		return 0;
+
+	while ((n = read(in->fd, in->block, IN_BLOCK)) < 0 && errno == EINTR)
+		; /* interrupted, try again */
+
+	if (n < 0)
+		perror("ERROR: Cannot read the input");
+
+	in->pos = 0;
+	in->len = (n > 0) ? n : 0;
+	if (n <= 0)
+		in->done = 1;
+
+	return n > 0;
+}
+
+/* @brief: Function that reads one byte of the input.
+ *		   Receives the reader.
+ *		   Returns the byte or EOF at the end of the input.
+ */
+int nextByte(Reader * in)
+{
+	return HAS_DATA(in) ? in->buf[in->pos++] : EOF;
+}
+
+/* @brief: Function that reads a text integer, skipping the blanks before it. Only digits and an optional minus
+ *		   sign are accepted, which is enough for the traces and much faster than scanf.
+ *
+ *		   Receives the reader.
+ */
+long readLong(Reader * in)
+{
+	long x = 0;
+	int negative = 0;
+
+	while (HAS_DATA(in) && (in->buf[in->pos] == ' ' || in->buf[in->pos] == '\t' || in->buf[in->pos] == '\r' ||
+		in->buf[in->pos] == '\n'))
+		in->pos++;
+
+	if (HAS_DATA(in) && in->buf[in->pos] == '-')
+	{
+		negative = 1;
+		in->pos++;
+	}
+
+	while (HAS_DATA(in) && in->buf[in->pos] >= '0' && in->buf[in->pos] <= '9')
+		x = x*10 + (in->buf[in->pos++] - '0');
+
+	return negative ? -x : x;
+}
+
+/* @brief: Function that reads a 32 bit little endian word of a binary trace.
+ *		   Receives the reader.
+ */
+unsigned long readWord(Reader * in)
+{
+	unsigned long x = 0;
+	int i, c;
+
+	for (i = 0; i < 4 && (c = nextByte(in)) != EOF; i++)
+		x |= (unsigned long) c << (8*i);
+
+	return x;
+}
+
+/* @brief: Function that reads the number of nodes at the begining of a trace and finds if it is binary. Text
+ *		   traces start with a digit so the first byte is enough to tell them apart.
+ *
+ *		   Receives the reader.
+ */
+int readSize(Reader * in)
+{
+	int i;
+
+	if (HAS_DATA(in) && in->buf[in->pos] == BINARY_MAGIC[0])
+	{
+		for (i = 0; i < 4; i++)
+			if (nextByte(in) != BINARY_MAGIC[i])
+				return 0;
+		in->binary = 1;
+		return (int) readWord(in);
+	}
+
+	return (int) readLong(in);
+}
+
+/* @brief: Function that reads the next command and its arguments. The third argument of a binary record is
+ *		   signed, the others are node numbers.
+ *
+ *		   Receives the reader and the array where the arguments are stored.
+ *		   Returns the command letter or EOF when the trace ends (command X or end of the input). Unknown commands
+ *		   are returned without arguments, the rest of the line is skipped in text traces and the binary ones
+ *		   stop since there is no way to know where the next record starts.
+ */
+int readCommand(Reader * in, long arg[MAX_ARGS])
+{
+	int command, i, n;
+	unsigned long word;
+
+	if (in->binary)
+		command = nextByte(in);
+	else
+	{
+		while (HAS_DATA(in) && (in->buf[in->pos] == ' ' || in->buf[in->pos] == '\t' || in->buf[in->pos] == '\r' ||
+			in->buf[in->pos] == '\n'))
+			in->pos++;
+		command = nextByte(in);
+	}
+
+	if (command == EOF || command == 'X')
+		return EOF;
+
+	if ((n = arity(command)) < 0)
+	{
+		if (in->binary)
+		{
+			in->done = 1;
+			in->pos = in->len;
+		}
+		else
+			while ((i = nextByte(in)) != EOF && i != '\n')
+				;
+		return command;
+	}
+
+	for (i = 0; i < n; i++)
+	{
+		if (!in->binary)
+			arg[i] = readLong(in);
+		else if ((word = readWord(in)) >= 0x80000000UL && i == 2)
+			arg[i] = -(long)(0xFFFFFFFFUL - word) - 1;
+		else
+			arg[i] = (long) word;
+	}
+
+	return command;
+}
+
+/* @brief: Function that gives the number of integer arguments of a command.
+ *		   Receives the command letter.
+ *		   Returns the number of arguments or -1 if the command is unknown.
+ */
+int arity(int command)
+{
+	switch (command)
+	{
+		case 'V': case 'B':
+			return 0;
+		case 'Z': case 'R': case 'K':
+			return 1;
+		case 'L': case 'C': case 'Q': case 'S': case 'N': case 'M': case 'T': case 'P': case 'D': case 'E':
+			return 2;
+		case 'A': case 'W':
+			return 3;
+		default:
+			return -1;
+	}
+}
+
+/* @brief: Function that creates a buffered writer.
+ *		   Receives the stream where the output goes.
+ */
+Writer* openWriter(FILE * stream)
+{
+	Writer * out = (Writer*) malloc(sizeof(Writer));
+
+	out->buf = (char*) malloc(OUT_BLOCK);
+	out->len = 0;
+	out->stream = stream;
+	out->first = NULL;
+
+	return out;
+}
+
+/* @brief: Function that flushes a writer and frees it.
+ *		   Receives the writer.
+ */
+void closeWriter(Writer * out)
+{
+	flushWriter(out);
+	free(out->buf);
+	free(out);
+}
+
+/* @brief: Function that writes the buffered output to the stream, after the one of the writer that goes first.
+ *		   Receives the writer.
+ */
+void flushWriter(Writer * out)
+{
+	if (out->first != NULL)
+		flushWriter(out->first);
+	fwrite(out->buf, 1, out->len, out->stream);
+	fflush(out->stream);
+	out->len = 0;
+}
+
+/* @brief: Function that writes one character.
+ *		   Receives the writer and the character.
+ */
+void writeChar(Writer * out, char c)
+{
+	if (out->len == OUT_BLOCK)
+		flushWriter(out);
+	out->buf[out->len++] = c;
+}
+
+/* @brief: Function that writes an integer in decimal.
+ *		   Receives the writer and the integer.
+ */
+void writeLong(Writer * out, long x)
+{
+	char digits[24];
+	unsigned long y = (x < 0) ? 0UL - (unsigned long) x : (unsigned long) x;
+	int n = 0;
+
+	do
+	{
+		digits[n++] = '0' + (char)(y % 10);
+		y /= 10;
+	} while (y > 0);
+
+	if (x < 0)
+		writeChar(out, '-');
+	while (n > 0)
+		writeChar(out, digits[--n]);
+}
+
+/* @brief: Function that writes a 32 bit little endian word, as in the binary traces.
+ *		   Receives the writer and the word.
+ */
+void writeWord(Writer * out, unsigned long word)
+{
+	int i;
+
+	for (i = 0; i < 4; i++)
+		writeChar(out, (char)((word >> (8*i)) & 0xFF));
+}
+
+/* @brief: Function that writes a string.
+ *		   Receives the writer and the string.
+ */
+void writeString(Writer * out, const char * s)
+{
+	while (*s != '\0')
+		writeChar(out, *s++);
+}
+
+/* @brief: Function that cuts a file after its first len bytes.
+ *
+ *		   Receives the path and the length.
+ *		   Returns 1 if the file was cut.
+ */
+int truncateFile(const char * path, long len)
+{
+	int fd, ok;
+
+	if ((fd = open(path, O_WRONLY)) < 0)
+		return 0;
+	ok = ftruncate(fd, (off_t) len) == 0;
+	close(fd);
+
+	return ok;
+}
@@ -0,0 +1,69 @@
+#ifndef IO_H
+#define IO_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+/************************************************** NOTE ********************************************************/
+/*  Input and output of the command stream. A trace is either text, the first line with the number of nodes    */
+/*  and then one command per line (EX: "L 1 2"), or binary. A binary trace starts with the 4 bytes "LCTB" and   */
+/*  the number of nodes, followed by one record per command: the command letter in one byte and then its        */
+/*  arguments as 32 bit little endian words (two for L, C and Q). Both end with the command X or at the end of   */
+/*  the input.                                                                                                  */
+/****************************************************************************************************************/
+
+#define BINARY_MAGIC "LCTB"
+
+/* Maximum number of arguments of a command. */
+#define MAX_ARGS 3
+
+/*
+ * @brief: Reads a trace from a file or from the standard input. Regular files are memory mapped, anything else
+ *		   (pipes, terminals) is read in large blocks.
+ */
+typedef struct
+{
+	const unsigned char * buf;
+	size_t len;
+	size_t pos;
+	/* block used when the input is not mapped */
+	unsigned char * block;
+	int fd;
+	int mapped;
+	int binary;
+	/* set when nothing else can be read, at the end of the input or after an unknown binary record */
+	int done;
+
+} Reader;
+
+typedef struct Writer Writer;
+
+/*
+ * @brief: Buffered output of the answers, only written to the stream when the buffer is full or flushed. The
+ *		   writer first (NULL for none) is flushed before it, so that the log has every command whose answer was
+ *		   written.
+ */
+struct Writer
+{
+	char * buf;
+	size_t len;
+	FILE * stream;
+	Writer * first;
+};
+
+Reader* openReader(const char * path);
+void closeReader(Reader * in);
+int readSize(Reader * in);
+int readCommand(Reader * in, long arg[MAX_ARGS]);
+int arity(int command);
+
+Writer* openWriter(FILE * stream);
+void closeWriter(Writer * out);
+void flushWriter(Writer * out);
+void writeChar(Writer * out, char c);
+void writeLong(Writer * out, long x);
+void writeWord(Writer * out, unsigned long word);
+void writeString(Writer * out, const char * s);
+int truncateFile(const char * path, long len);
+
+#endif
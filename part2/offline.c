@@ -0,0 +1,457 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "io.h"
+#include "pairs.h"
+
+/************************************************** NOTE ********************************************************/
+/*  Offline connectivity for traces that are known up front. The trace has the same format as the one of LCT.c */
+/*  but the graph does not need to be a forest: L adds an edge even when it closes a cycle (links of the same   */
+/*  pair are counted, each C removes one of them) and Q answers if u and v are connected in the graph. Every     */
+/*  edge is alive in an interval of queries, the interval is split over the nodes of a segment tree over the     */
+/*  queries and a depth first search of that tree adds the edges of each node to a union find that is rolled    */
+/*  back on the way up. This gives O(q log q log n) for the whole trace. A command with a node that does not     */
+/*  exist is kept as a query that prints the same error as LCT.c, so the two outputs have the same lines.        */
+/****************************************************************************************************************/
+
+/*
+ * @brief: Union find with union by size and no path compression, so that every union can be undone.
+ */
+typedef struct
+{
+	int * parent;
+	int * size;
+	/* roots that were hung by the unions, in order */
+	int * history;
+	int nHistory;
+
+} RollbackDSU;
+
+/*
+ * @brief: An edge and the queries [first, last[ during which it is alive.
+ */
+typedef struct
+{
+	int u;
+	int v;
+	int first;
+	int last;
+
+} Interval;
+
+/*
+ * @brief: The whole trace and the structures built from it.
+ */
+typedef struct
+{
+	int V;
+	/* queries in the order of the trace, qu is -1 for the commands with the node unknown[i] that does not exist */
+	int * qu;
+	int * qv;
+	long * unknown;
+	char * answer;
+	int nQueries;
+	/* alive intervals of the edges */
+	Interval * edges;
+	int nEdges;
+	/* edges of each node of the segment tree, node i owns segEdges[segStart[i]..segStart[i+1][ */
+	int * segStart;
+	int * segEdges;
+	int nSeg;
+
+} Offline;
+
+/************************************************ SIGNATURES ****************************************************/
+RollbackDSU* createDSU(int V);
+void freeDSU(RollbackDSU * dsu);
+int findDSU(RollbackDSU * dsu, int u);
+void unionDSU(RollbackDSU * dsu, int u, int v);
+void rollback(RollbackDSU * dsu, int nHistory);
+
+Offline* readTrace(Reader * in);
+void freeOffline(Offline * off);
+void computeIntervals(Offline * off, int * cmd, int * eu, int * ev, long * bad, int nOps);
+void coverInterval(Offline * off, int node, int lo, int hi, Interval * e, int index, int fill);
+void buildSegmentTree(Offline * off);
+void solve(Offline * off, RollbackDSU * dsu, int node, int lo, int hi);
+
+/*****************************************************************************************************************/
+int main(int argc, char * argv[])
+{
+	Reader * in;
+	Writer * out;
+	Offline * off;
+	RollbackDSU * dsu;
+	int i;
+
+	if ((in = openReader(argc > 1 ? argv[1] : NULL)) == NULL)
+	{
+		fprintf(stderr, "ERROR: Can not open %s\n", argv[1]);
+		return EXIT_FAILURE;
+	}
+
+	off = readTrace(in);
+	closeReader(in);
+
+	buildSegmentTree(off);
+	dsu = createDSU(off->V);
+	if (off->nQueries > 0)
+		solve(off, dsu, 1, 0, off->nQueries);
+
+	out = openWriter(stdout);
+	for (i = 0; i < off->nQueries; i++)
+	{
+		if (off->qu[i] < 0)
+		{
+			writeString(out, "ERROR: Unknown node ");
+			writeLong(out, off->unknown[i]);
+		}
+		else
+			writeChar(out, off->answer[i] ? 'T' : 'F');
+		writeChar(out, '\n');
+	}
+	closeWriter(out);
+
+	freeDSU(dsu);
+	freeOffline(off);
+	return EXIT_SUCCESS;
+}
+
+/* @brief: Function that reads the whole trace and computes the alive interval of every edge. Commands other
+ *		   than L, C and Q are skipped with a warning since they need the online LCT, the ones with a node that does
+ *		   not exist become U commands that only print an error.
+ *
+ *		   Receives the reader of the trace.
+ */
+Offline* readTrace(Reader * in)
+{
+	Offline * off = (Offline*) malloc(sizeof(Offline));
+	int * cmd, * eu, * ev;
+	long * bad;
+	int nOps = 0, capacity = 1024, skipped = 0, command, i;
+	long arg[MAX_ARGS];
+
+	off->V = readSize(in);
+	cmd = (int*) malloc(sizeof(int)*capacity);
+	eu = (int*) malloc(sizeof(int)*capacity);
+	ev = (int*) malloc(sizeof(int)*capacity);
+	bad = (long*) malloc(sizeof(long)*capacity);
+
+	while ((command = readCommand(in, arg)) != EOF)
+	{
+		if (command != 'L' && command != 'C' && command != 'Q')
+		{
+			skipped++;
+			continue;
+		}
+		if (nOps == capacity)
+		{
+			capacity *= 2;
+			cmd = (int*) realloc(cmd, sizeof(int)*capacity);
+			eu = (int*) realloc(eu, sizeof(int)*capacity);
+			ev = (int*) realloc(ev, sizeof(int)*capacity);
+			bad = (long*) realloc(bad, sizeof(long)*capacity);
+		}
+		for (i = 0; i < 2 && arg[i] >= 1 && arg[i] <= off->V; i++)
+			;
+		cmd[nOps] = (i < 2) ? 'U' : command;
+		eu[nOps] = (int)arg[0] - 1;
+		ev[nOps] = (int)arg[1] - 1;
+		bad[nOps] = (i < 2) ? arg[i] : 0;
+		nOps++;
+	}
+	if (skipped > 0)
+		fprintf(stderr, "WARNING: %d commands other than L, C and Q were skipped\n", skipped);
+
+	computeIntervals(off, cmd, eu, ev, bad, nOps);
+
+	free(cmd);
+	free(eu);
+	free(ev);
+	free(bad);
+	return off;
+}
+
+/* @brief: Function that frees the trace.
+ *		   Receives the trace.
+ */
+void freeOffline(Offline * off)
+{
+	free(off->qu);
+	free(off->qv);
+	free(off->unknown);
+	free(off->answer);
+	free(off->edges);
+	free(off->segStart);
+	free(off->segEdges);
+	free(off);
+}
+
+/* @brief: Function that finds the alive interval of every edge. A link opens an interval at the number of
+ *		   queries seen so far and the next cut of the same pair closes the most recent open one, intervals still
+ *		   open at the end of the trace last until the last query. The open intervals of each pair are kept in a
+ *		   hash table with linear probing, as a stack linked through next.
+ *
+ *		   Receives the trace, its L, C, Q and U commands and the unknown node of each U.
+ */
+void computeIntervals(Offline * off, int * cmd, int * eu, int * ev, long * bad, int nOps)
+{
+	int * table, * next, * openU, * openV, * openFirst;
+	int i, slot, e, nLinks = 0, nOpen = 0, nQueries = 0;
+	unsigned long mask = 1;
+
+	for (i = 0; i < nOps; i++)
+	{
+		nLinks += (cmd[i] == 'L');
+		nQueries += (cmd[i] == 'Q' || cmd[i] == 'U');
+	}
+
+	while (mask < 2UL*nLinks + 2)
+		mask <<= 1;
+	table = (int*) malloc(sizeof(int)*mask);
+	for (i = 0; i < (int)mask; i++)
+		table[i] = -1;
+	mask--;
+
+	next = (int*) malloc(sizeof(int)*(nLinks + 1));
+	openU = (int*) malloc(sizeof(int)*(nLinks + 1));
+	openV = (int*) malloc(sizeof(int)*(nLinks + 1));
+	openFirst = (int*) malloc(sizeof(int)*(nLinks + 1));
+
+	off->qu = (int*) malloc(sizeof(int)*(nQueries + 1));
+	off->qv = (int*) malloc(sizeof(int)*(nQueries + 1));
+	off->unknown = (long*) malloc(sizeof(long)*(nQueries + 1));
+	off->answer = (char*) malloc(nQueries + 1);
+	off->edges = (Interval*) malloc(sizeof(Interval)*(nLinks + 1));
+	off->nQueries = 0;
+	off->nEdges = 0;
+
+	for (i = 0; i < nOps; i++)
+	{
+		if (cmd[i] == 'Q' || cmd[i] == 'U')
+		{
+			off->qu[off->nQueries] = (cmd[i] == 'Q') ? eu[i] : -1;
+			off->qv[off->nQueries] = ev[i];
+			off->unknown[off->nQueries] = bad[i];
+			off->nQueries++;
+			continue;
+		}
+		if (eu[i] == ev[i])
+			continue; /* loops never change the connectivity */
+
+		/* slot of the pair, or the empty slot where it goes */
+		for (slot = pairHash(eu[i], ev[i]) & mask; table[slot] != -1; slot = (slot + 1) & mask)
+		{
+			e = table[slot];
+			if ((openU[e] == eu[i] && openV[e] == ev[i]) || (openU[e] == ev[i] && openV[e] == eu[i]))
+				break;
+		}
+
+		if (cmd[i] == 'L')
+		{
+			openU[nOpen] = eu[i];
+			openV[nOpen] = ev[i];
+			openFirst[nOpen] = off->nQueries;
+			next[nOpen] = table[slot];
+			table[slot] = nOpen++;
+		}
+		else if ((e = table[slot]) != -1 && openFirst[e] >= 0)
+		{
+			/* the slot keeps the pair even when its stack is empty, marked by a negative first */
+			off->edges[off->nEdges].u = eu[i];
+			off->edges[off->nEdges].v = ev[i];
+			off->edges[off->nEdges].first = openFirst[e];
+			off->edges[off->nEdges].last = off->nQueries;
+			off->nEdges++;
+			openFirst[e] = -1;
+			if (next[e] != -1)
+				table[slot] = next[e];
+		}
+	}
+
+	/* intervals that are still open */
+	for (slot = 0; slot <= (int)mask; slot++)
+		for (e = table[slot]; e != -1 && openFirst[e] >= 0; e = next[e])
+		{
+			off->edges[off->nEdges].u = openU[e];
+			off->edges[off->nEdges].v = openV[e];
+			off->edges[off->nEdges].first = openFirst[e];
+			off->edges[off->nEdges].last = off->nQueries;
+			off->nEdges++;
+		}
+
+	free(table);
+	free(next);
+	free(openU);
+	free(openV);
+	free(openFirst);
+}
+
+/* @brief: Function that visits the nodes of the segment tree that cover the interval of an edge. In the first
+ *		   pass (fill == 0) it counts the edges of each node, in the second one it stores them.
+ *
+ *		   Receives the trace, the node and its range [lo, hi[ of queries, the interval and its index and the pass.
+ */
+void coverInterval(Offline * off, int node, int lo, int hi, Interval * e, int index, int fill)
+{
+	int mid;
+
+	if (e->last <= lo || hi <= e->first)
+		return;
+
+	if (e->first <= lo && hi <= e->last)
+	{
+		if (fill)
+			off->segEdges[off->segStart[node]++] = index;
+		else
+			off->segStart[node]++;
+		return;
+	}
+
+	mid = (lo + hi) / 2;
+	coverInterval(off, 2*node, lo, mid, e, index, fill);
+	coverInterval(off, 2*node + 1, mid, hi, e, index, fill);
+}
+
+/* @brief: Function that distributes the edges over the segment tree. The edges of all the nodes are stored in
+ *		   one array, counted first and then filled, so that the edges of a node are contiguous.
+ *
+ *		   Receives the trace.
+ */
+void buildSegmentTree(Offline * off)
+{
+	int i, total = 0, count;
+
+	off->nSeg = 4*off->nQueries + 4;
+	off->segStart = (int*) calloc(off->nSeg + 1, sizeof(int));
+
+	for (i = 0; i < off->nEdges; i++)
+		if (off->edges[i].first < off->edges[i].last)
+			coverInterval(off, 1, 0, off->nQueries, &off->edges[i], i, 0);
+
+	/* segStart holds the counts, turn them into the first position of each node */
+	for (i = 0; i <= off->nSeg; i++)
+	{
+		count = off->segStart[i];
+		off->segStart[i] = total;
+		total += count;
+	}
+	off->segEdges = (int*) malloc(sizeof(int)*(total + 1));
+
+	for (i = 0; i < off->nEdges; i++)
+		if (off->edges[i].first < off->edges[i].last)
+			coverInterval(off, 1, 0, off->nQueries, &off->edges[i], i, 1);
+
+	/* the second pass moved each start to the start of the next node */
+	for (i = off->nSeg; i > 0; i--)
+		off->segStart[i] = off->segStart[i - 1];
+	off->segStart[0] = 0;
+}
+
+/* @brief: Function that answers the queries of a node of the segment tree. The edges of the node are added to
+ *		   the union find, the children are solved and the unions are undone before returning.
+ *
+ *		   Receives the trace, the union find, the node and its range [lo, hi[ of queries.
+ */
+void solve(Offline * off, RollbackDSU * dsu, int node, int lo, int hi)
+{
+	Interval * e;
+	int i, mark = dsu->nHistory, mid;
+
+	for (i = off->segStart[node]; i < off->segStart[node + 1]; i++)
+	{
+		e = &off->edges[off->segEdges[i]];
+		unionDSU(dsu, e->u, e->v);
+	}
+
+	if (hi - lo == 1)
+		off->answer[lo] = (off->qu[lo] >= 0) &&
+			((off->qu[lo] == off->qv[lo]) || (findDSU(dsu, off->qu[lo]) == findDSU(dsu, off->qv[lo])));
+	else
+	{
+		mid = (lo + hi) / 2;
+		solve(off, dsu, 2*node, lo, mid);
+		solve(off, dsu, 2*node + 1, mid, hi);
+	}
+
+	rollback(dsu, mark);
+}
+
+/* @brief: Function to allocate a union find where every node is alone.
+ *		   Receives an integer which defines the number of nodes.
+ */
+RollbackDSU* createDSU(int V)
+{
+	RollbackDSU * dsu = (RollbackDSU*) malloc(sizeof(RollbackDSU));
+	int i;
+
+	dsu->parent = (int*) malloc(sizeof(int)*V);
+	dsu->size = (int*) malloc(sizeof(int)*V);
+	dsu->history = (int*) malloc(sizeof(int)*V);
+	dsu->nHistory = 0;
+	for (i = 0; i < V; i++)
+	{
+		dsu->parent[i] = i;
+		dsu->size[i] = 1;
+	}
+
+	return dsu;
+}
+
+/* @brief: Function to free the memory of a union find.
+ *		   Receives a pointer to the union find.
+ */
+void freeDSU(RollbackDSU * dsu)
+{
+	free(dsu->parent);
+	free(dsu->size);
+	free(dsu->history);
+	free(dsu);
+}
+
+/* @brief: Function that finds the root of the set of u. Union by size keeps it O(log n).
+ */
+int findDSU(RollbackDSU * dsu, int u)
+{
+	while (dsu->parent[u] != u)
+		u = dsu->parent[u];
+	return u;
+}
+
+/* @brief: Function that joins the sets of u and v, hanging the smaller root from the bigger one. Only unions
+ *		   that change something are stored, so there are at most V-1 of them in the history.
+ */
+void unionDSU(RollbackDSU * dsu, int u, int v)
+{
+	int aux;
+
+	u = findDSU(dsu, u);
+	v = findDSU(dsu, v);
+	if (u == v)
+		return;
+
+	if (dsu->size[u] > dsu->size[v])
+	{
+		aux = u;
+		u = v;
+		v = aux;
+	}
+	dsu->parent[u] = v;
+	dsu->size[v] += dsu->size[u];
+	dsu->history[dsu->nHistory++] = u;
+}
+
+/* @brief: Function that undoes the unions done after the history had nHistory entries.
+ */
+void rollback(RollbackDSU * dsu, int nHistory)
+{
+	int u;
+
+	while (dsu->nHistory > nHistory)
+	{
+		u = dsu->history[--dsu->nHistory];
+		dsu->size[dsu->parent[u]] -= dsu->size[u];
+		dsu->parent[u] = u;
+	}
+}
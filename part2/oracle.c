@@ -0,0 +1,1023 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "io.h"
+#include "xorshift.h"
+
+/************************************************** NOTE ********************************************************/
+/*  Differential tester of ./test and ./offline. Random traces are answered by a reference graph kept as        */
+/*  adjacency lists, where every question is a BFS, and by the program of each target, and the two outputs are  */
+/*  compared line by line. The minimum spanning forest of the W edges is kept apart as lists of edges, and its  */
+/*  heaviest edge on a path is found with a BFS too. Each target draws its commands from its own mix and has    */
+/*  one of two kinds:                                                                                           */
+/*      FOREST: links of connected nodes are ignored, as by the LCT and the Euler tour trees.                   */
+/*      GRAPH: every link adds an edge, closing cycles and repeating pairs, as in hdt and ./offline.            */
+/*  A trace can hold RESTART: it is then written in parts and ./test is started again for each one, with the    */
+/*  snapshot and the log of the parts before it, so its output must be the one of a run without restarts.       */
+/*  A failing trace is shrunk by removing blocks of commands while it still fails and written to FAIL_FILE.    */
+/*  With -p the commands per second of each target on a fixed ./workload trace are appended to a file of       */
+/*  baselines, one line per commit and target, and compared with the last line of the same target.             */
+/****************************************************************************************************************/
+
+#define TRACE_FILE "oracle.in"
+#define EXPECTED_FILE "oracle.expected"
+#define OUTPUT_FILE "oracle.out"
+#define STATS_FILE "oracle.stats"
+#define COMMIT_FILE "oracle.commit"
+#define FAIL_FILE "oracle.fail.in"
+#define SNAPSHOT_FILE "oracle.snap"
+#define LOG_FILE "oracle.log"
+
+/* longest line of the outputs, the answer of N lists every node of the path that holds the minimum */
+#define LINE_SIZE (1 << 16)
+
+/* the ./workload trace of the baselines */
+#define PERF_TRACE "./workload random 100000 1000000 -s 1 -b"
+
+/* command of the traces where ./test is stopped and started again, it is not written to the trace */
+#define RESTART '!'
+
+/* the W weights are spread over more than 32 bits, so that they are checked across a restart */
+#define WEIGHT_SCALE 65536L
+
+#define FOREST 0
+#define GRAPH 1
+
+/*
+ * @brief: A program that is checked, the commands of its traces (each letter is drawn with the frequency it has in
+ *		   mix), its kind, whether it prints the statistics of ./test, for the baselines, and the length of a path
+ *		   that is linked in order at the start of its traces (0 for none), whose hooks are as long as the path.
+ */
+typedef struct
+{
+	const char * name;
+	const char * program;
+	const char * mix;
+	int kind;
+	int stats;
+	int chain;
+
+} Target;
+
+Target targets[] = {
+	{ "lct", "./test", "LLLLLCCCQQQQZZAASSNMTTRPPDDWWWEEVK", FOREST, 1, 0 },
+	{ "lct-j4", "./test -j 4", "LLLLLCCCQQQQZZAASSNMTTRPPDDWWWEEVK", FOREST, 1, 0 },
+	{ "lct-j4-chain", "./test -j 4", "LLLLLCCCQQQQQQQQZ", FOREST, 0, 200 },
+	{ "lct-restart", "./test -s " SNAPSHOT_FILE " -l " LOG_FILE, "LLLLLCCCQQQQZZAASSNMTTRPPDDWWWEEVKB!", FOREST, 0, 0 },
+	{ "ett", "./test -b ett", "LLLLLCCCQQQQZZ", FOREST, 1, 0 },
+	{ "hdt", "./test -b hdt", "LLLLLCCCQQQQZZ", GRAPH, 1, 0 },
+	{ "offline", "./offline", "LLLLLCCCQQQQ", GRAPH, 0, 0 },
+	{ NULL, NULL, NULL, 0, 0, 0 } };
+
+typedef struct
+{
+	int command;
+	int u;
+	int v;
+	long x;
+
+} Command;
+
+/* @brief: A trace over n starting nodes, the nodes are numbered from 0 as in LCT.c. */
+typedef struct
+{
+	int n;
+	int size;
+	Command * commands;
+
+} Trace;
+
+/*
+ * @brief: The reference graph, a forest unless the target is GRAPH, and the minimum spanning forest of the W edges.
+ *		   Nodes created by V go after the n starting ones, up to capacity, and deleted nodes are reused last
+ *		   deleted first, like the forest of LCT.c.
+ */
+typedef struct
+{
+	int size;
+	int capacity;
+	int ** adj;
+	int * deg;
+	int * room;
+	long * val;
+	int * alive;
+	int * freeIds;
+	int nFree;
+	/* root of the P command */
+	int root;
+	/* minimum spanning forest, its adjacency lists hold the numbers of the edges */
+	int ** msfAdj;
+	int * msfDeg;
+	int * msfRoom;
+	int * endA;
+	int * endB;
+	long * weight;
+	int nEdges;
+	long total;
+	/* BFS state, seen[v] == stamp for the nodes of the last search, whose edge to parent[v] is parentEdge[v] */
+	int * parent;
+	int * parentEdge;
+	int * queue;
+	int * seen;
+	int stamp;
+	/* mark[v] == stamp for the nodes below a node or above it, after a search */
+	int * mark;
+
+} Reference;
+
+/************************************************ SIGNATURES ****************************************************/
+/* Reference functions */
+Reference* createReference(int n, int capacity);
+void freeReference(Reference * r);
+void pushAdjacent(int ** adj, int * deg, int * room, int w, int x);
+void dropAdjacent(int ** adj, int * deg, int w, int x);
+int search(Reference * r, int u, int v);
+int hasEdge(Reference * r, int u, int v);
+void addEdge(Reference * r, int u, int v);
+void removeEdge(Reference * r, int u, int v);
+int heaviestEdge(Reference * r, int u, int v);
+void insertEdge(Reference * r, int u, int v, long w);
+void execute(Reference * r, Command * c, int kind, FILE * expected);
+
+/* Trace functions */
+int randomNode(Reference * r);
+Trace* generateTrace(int n, int ops, Target * target);
+void freeTrace(Trace * trace);
+int simulate(Trace * trace, int kind, FILE * expected);
+int writeTrace(Trace * trace, const char * path);
+int check(Trace * trace, Target * target, int * line);
+int compareOutputs(int * line);
+Trace* shrink(Trace * trace, Target * target);
+void recordBaseline(const char * path, Target * target);
+
+/*****************************************************************************************************************/
+
+unsigned long seed = 1;
+
+/* @brief: ./oracle [-r rounds] [-n nodes] [-o ops] [-s seed] [-t target] [-p baselines]
+ *		   Runs rounds random traces (100 by default) with up to nodes nodes (30) and ops commands (1000) through
+ *		   every target, or only the one named by -t, and stops at the first trace that gives a different output.
+ *		   Round r uses the seed seed + r for every target, so a failure is reproduced with -s, -r 1 and -t.
+ *		   ./test and ./offline must be in the current directory, and ./workload too for -p.
+ *         EX: ./oracle -r 1000 -p baselines.txt
+ */
+int main(int argc, char * argv[])
+{
+	const char * only = NULL, * baselines = NULL;
+	unsigned long first = 1;
+	int rounds = 100, nodes = 30, ops = 1000, r, k, n, line;
+	Trace * trace, * small;
+
+	for (k = 1; k < argc; k++)
+	{
+		if (strcmp(argv[k], "-r") == 0 && k + 1 < argc)
+			rounds = atoi(argv[++k]);
+		else if (strcmp(argv[k], "-n") == 0 && k + 1 < argc)
+			nodes = atoi(argv[++k]);
+		else if (strcmp(argv[k], "-o") == 0 && k + 1 < argc)
+			ops = atoi(argv[++k]);
+		else if (strcmp(argv[k], "-s") == 0 && k + 1 < argc)
+			first = strtoul(argv[++k], NULL, 10);
+		else if (strcmp(argv[k], "-t") == 0 && k + 1 < argc)
+			only = argv[++k];
+		else if (strcmp(argv[k], "-p") == 0 && k + 1 < argc)
+			baselines = argv[++k];
+		else
+		{
+			fprintf(stderr, "ERROR: Unknown option %s\n", argv[k]);
+			return EXIT_FAILURE;
+		}
+	}
+	if (nodes < 2 || ops < 1)
+	{
+		fprintf(stderr, "ERROR: Invalid nodes or ops\n");
+		return EXIT_FAILURE;
+	}
+
+	for (r = 0; r < rounds; r++)
+	{
+		for (k = 0; targets[k].name != NULL; k++)
+		{
+			if (only != NULL && strcmp(only, targets[k].name) != 0)
+				continue;
+
+			/* the generator starts again for each target, so its trace does not depend on the others */
+			seed = xorshiftSeed(first + r);
+			n = 2 + xorshiftBelow(&seed, nodes - 1);
+			n = (n < targets[k].chain) ? targets[k].chain : n;
+			trace = generateTrace(n, ops, &targets[k]);
+			if (check(trace, &targets[k], &line))
+			{
+				freeTrace(trace);
+				continue;
+			}
+
+			printf("FAIL: %s differs from the reference at line %d of the output (seed %lu)\n", targets[k].name, line,
+				first + r);
+			small = shrink(trace, &targets[k]);
+			n = writeTrace(small, FAIL_FILE);
+			printf("shrunk to %d commands over %d nodes in %s", small->size, small->n, FAIL_FILE);
+			if (n == 2)
+				printf(" and %s.1, run after a restart", FAIL_FILE);
+			else if (n > 2)
+				printf(" and %s.1 to %s.%d, each one run after a restart", FAIL_FILE, FAIL_FILE, n - 1);
+			printf("\n");
+			freeTrace(small);
+			freeTrace(trace);
+			return EXIT_FAILURE;
+		}
+	}
+	printf("%d rounds passed\n", rounds);
+
+	if (baselines != NULL)
+		for (k = 0; targets[k].name != NULL; k++)
+			if (targets[k].stats && (only == NULL || strcmp(only, targets[k].name) == 0))
+				recordBaseline(baselines, &targets[k]);
+
+	remove(TRACE_FILE);
+	remove(EXPECTED_FILE);
+	remove(OUTPUT_FILE);
+	remove(STATS_FILE);
+	remove(COMMIT_FILE);
+	remove(SNAPSHOT_FILE);
+	remove(LOG_FILE);
+	return EXIT_SUCCESS;
+}
+
+/* @brief: Function that creates a reference graph with n nodes without edges and room for capacity nodes and
+ *		   capacity edges in the minimum spanning forest.
+ *
+ *		   Receives the number of nodes and the capacity.
+ */
+Reference* createReference(int n, int capacity)
+{
+	Reference * r = (Reference*) malloc(sizeof(Reference));
+	int i;
+
+	r->size = n;
+	r->capacity = capacity;
+	r->adj = (int**) malloc(sizeof(int*)*capacity);
+	r->deg = (int*) malloc(sizeof(int)*capacity);
+	r->room = (int*) malloc(sizeof(int)*capacity);
+	r->val = (long*) malloc(sizeof(long)*capacity);
+	r->alive = (int*) malloc(sizeof(int)*capacity);
+	r->freeIds = (int*) malloc(sizeof(int)*capacity);
+	r->msfAdj = (int**) malloc(sizeof(int*)*capacity);
+	r->msfDeg = (int*) malloc(sizeof(int)*capacity);
+	r->msfRoom = (int*) malloc(sizeof(int)*capacity);
+	r->endA = (int*) malloc(sizeof(int)*capacity);
+	r->endB = (int*) malloc(sizeof(int)*capacity);
+	r->weight = (long*) malloc(sizeof(long)*capacity);
+	r->parent = (int*) malloc(sizeof(int)*capacity);
+	r->parentEdge = (int*) malloc(sizeof(int)*capacity);
+	r->queue = (int*) malloc(sizeof(int)*capacity);
+	r->seen = (int*) malloc(sizeof(int)*capacity);
+	r->mark = (int*) malloc(sizeof(int)*capacity);
+	r->nFree = 0;
+	r->root = 0;
+	r->nEdges = 0;
+	r->total = 0;
+	r->stamp = 0;
+
+	for (i = 0; i < capacity; i++)
+	{
+		r->adj[i] = r->msfAdj[i] = NULL;
+		r->deg[i] = r->msfDeg[i] = 0;
+		r->room[i] = r->msfRoom[i] = 0;
+		r->val[i] = 0;
+		r->alive[i] = i < n;
+		r->seen[i] = r->mark[i] = 0;
+	}
+
+	return r;
+}
+
+/* @brief: Function to free the memory of a reference graph.
+ *		   Receives a pointer to the graph.
+ */
+void freeReference(Reference * r)
+{
+	int i;
+
+	for (i = 0; i < r->capacity; i++)
+	{
+		free(r->adj[i]);
+		free(r->msfAdj[i]);
+	}
+	free(r->adj);
+	free(r->deg);
+	free(r->room);
+	free(r->val);
+	free(r->alive);
+	free(r->freeIds);
+	free(r->msfAdj);
+	free(r->msfDeg);
+	free(r->msfRoom);
+	free(r->endA);
+	free(r->endB);
+	free(r->weight);
+	free(r->parent);
+	free(r->parentEdge);
+	free(r->queue);
+	free(r->seen);
+	free(r->mark);
+	free(r);
+}
+
+/* @brief: Function that appends x to the adjacency list of w, growing it when it is full.
+ *		   Receives the lists, their sizes and capacities, w and x.
+ */
+void pushAdjacent(int ** adj, int * deg, int * room, int w, int x)
+{
+	if (deg[w] == room[w])
+	{
+		room[w] = room[w] ? 2*room[w] : 4;
+		adj[w] = (int*) realloc(adj[w], sizeof(int)*room[w]);
+	}
+	adj[w][deg[w]++] = x;
+}
+
+/* @brief: Function that removes one x, which must be there, from the adjacency list of w.
+ *		   Receives the lists, their sizes, w and x.
+ */
+void dropAdjacent(int ** adj, int * deg, int w, int x)
+{
+	int j;
+
+	for (j = 0; adj[w][j] != x; j++)
+		;
+	adj[w][j] = adj[w][--deg[w]];
+}
+
+/* @brief: Function that makes a BFS from u, after it parent leads every node of the tree of u back to u and the
+ *		   queue holds the nodes of the tree in the order they were found.
+ *
+ *		   Receives the graph and the nodes.
+ *		   Returns the number of nodes in the tree of u if v is in it and 0 otherwise.
+ */
+int search(Reference * r, int u, int v)
+{
+	int head = 0, tail = 0, w, i;
+
+	r->stamp++;
+	r->seen[u] = r->stamp;
+	r->parent[u] = -1;
+	r->queue[tail++] = u;
+
+	while (head < tail)
+	{
+		w = r->queue[head++];
+		for (i = 0; i < r->deg[w]; i++)
+			if (r->seen[r->adj[w][i]] != r->stamp)
+			{
+				r->seen[r->adj[w][i]] = r->stamp;
+				r->parent[r->adj[w][i]] = w;
+				r->queue[tail++] = r->adj[w][i];
+			}
+	}
+
+	return (r->seen[v] == r->stamp) ? tail : 0;
+}
+
+/* @brief: Function that checks if there is an edge between u and v.
+ *
+ *		   Receives the graph and the nodes.
+ *		   Returns 1 if there is and 0 otherwise.
+ */
+int hasEdge(Reference * r, int u, int v)
+{
+	int i;
+
+	for (i = 0; i < r->deg[u]; i++)
+		if (r->adj[u][i] == v)
+			return 1;
+
+	return 0;
+}
+
+/* @brief: Function that adds the edge (u, v) to the adjacency lists.
+ *		   Receives the graph and the nodes.
+ */
+void addEdge(Reference * r, int u, int v)
+{
+	pushAdjacent(r->adj, r->deg, r->room, u, v);
+	pushAdjacent(r->adj, r->deg, r->room, v, u);
+}
+
+/* @brief: Function that removes one edge (u, v), which must exist, from the adjacency lists.
+ *		   Receives the graph and the nodes.
+ */
+void removeEdge(Reference * r, int u, int v)
+{
+	dropAdjacent(r->adj, r->deg, u, v);
+	dropAdjacent(r->adj, r->deg, v, u);
+}
+
+/* @brief: Function that finds the heaviest edge of the path between u and v in the minimum spanning forest, with
+ *		   a BFS from u over its edges.
+ *
+ *		   Receives the graph and the nodes.
+ *		   Returns the number of the edge or -1 if u == v or they are not connected.
+ */
+int heaviestEdge(Reference * r, int u, int v)
+{
+	int head = 0, tail = 0, w, x, k, i, heavy = -1;
+
+	r->stamp++;
+	r->seen[u] = r->stamp;
+	r->queue[tail++] = u;
+
+	while (head < tail)
+	{
+		w = r->queue[head++];
+		for (i = 0; i < r->msfDeg[w]; i++)
+		{
+			k = r->msfAdj[w][i];
+			x = (r->endA[k] == w) ? r->endB[k] : r->endA[k];
+			if (r->seen[x] != r->stamp)
+			{
+				r->seen[x] = r->stamp;
+				r->parent[x] = w;
+				r->parentEdge[x] = k;
+				r->queue[tail++] = x;
+			}
+		}
+	}
+
+	if (u == v || r->seen[v] != r->stamp)
+		return -1;
+	for (w = v; w != u; w = r->parent[w])
+		if (heavy == -1 || r->weight[r->parentEdge[w]] > r->weight[heavy])
+			heavy = r->parentEdge[w];
+
+	return heavy;
+}
+
+/* @brief: Function that inserts the edge (u, v) of weight w in the minimum spanning forest, replacing the heaviest
+ *		   edge of the path between u and v when it is heavier, like insertEdge of LCT.c.
+ *
+ *		   Receives the graph, the ends and the weight.
+ */
+void insertEdge(Reference * r, int u, int v, long w)
+{
+	int k = heaviestEdge(r, u, v);
+
+	if (u == v || (k == -1 && r->seen[v] == r->stamp) || (k != -1 && r->weight[k] <= w))
+		return;
+
+	if (k != -1)
+	{
+		dropAdjacent(r->msfAdj, r->msfDeg, r->endA[k], k);
+		dropAdjacent(r->msfAdj, r->msfDeg, r->endB[k], k);
+		r->total -= r->weight[k];
+	}
+
+	k = r->nEdges++;
+	r->endA[k] = u;
+	r->endB[k] = v;
+	r->weight[k] = w;
+	pushAdjacent(r->msfAdj, r->msfDeg, r->msfRoom, u, k);
+	pushAdjacent(r->msfAdj, r->msfDeg, r->msfRoom, v, k);
+	r->total += w;
+}
+
+/* @brief: Function that runs one command on the reference graph and writes its answer, as ./test does. In a GRAPH
+ *		   a link always adds an edge, in a forest only when the nodes are not connected. The answer of N lists
+ *		   every node of the path that holds the minimum, separated by |, since any of them is right.
+ *
+ *		   Receives the graph, the command and the file of the answers (NULL when they are not needed).
+ */
+void execute(Reference * r, Command * c, int kind, FILE * expected)
+{
+	long sum, min, max;
+	int w, n, k;
+
+	switch (c->command)
+	{
+		case 'L':
+			if (kind == GRAPH ? c->u != c->v : !search(r, c->u, c->v))
+				addEdge(r, c->u, c->v);
+			break;
+
+		case 'C':
+			if (hasEdge(r, c->u, c->v))
+				removeEdge(r, c->u, c->v);
+			break;
+
+		case 'Q':
+			if (expected) fprintf(expected, "%c\n", search(r, c->u, c->v) ? 'T' : 'F');
+			break;
+
+		case 'Z':
+			if (expected) fprintf(expected, "%d\n", search(r, c->u, c->u));
+			break;
+
+		case 'A': case 'S': case 'N': case 'M':
+			if (!search(r, c->u, c->v))
+			{
+				if (expected && c->command != 'A') fprintf(expected, "F\n");
+				break;
+			}
+			/* the path is v and its parents up to u */
+			for (w = c->v, sum = 0, min = max = r->val[w] + ((c->command == 'A') ? c->x : 0); w != -1; w = r->parent[w])
+			{
+				r->val[w] += (c->command == 'A') ? c->x : 0;
+				sum += r->val[w];
+				min = (r->val[w] < min) ? r->val[w] : min;
+				max = (r->val[w] > max) ? r->val[w] : max;
+			}
+			if (expected && (c->command == 'S' || c->command == 'M'))
+				fprintf(expected, "%ld\n", (c->command == 'S') ? sum : max);
+			if (expected && c->command == 'N')
+			{
+				for (w = c->v, n = 0; w != -1; w = r->parent[w])
+					if (r->val[w] == min)
+						fprintf(expected, (n++ > 0) ? "|%ld %d" : "%ld %d", min, w + 1);
+				fprintf(expected, "\n");
+			}
+			break;
+
+		case 'T':
+			/* in the order of the BFS from u the parent of a node comes first, so it is below v when its parent is */
+			if ((n = search(r, c->u, c->v)) != 0)
+			{
+				r->stamp++;
+				for (k = 0, w = 0; k < n; k++)
+					if (r->queue[k] == c->v || (r->parent[r->queue[k]] != -1 && r->mark[r->parent[r->queue[k]]] == r->stamp))
+					{
+						r->mark[r->queue[k]] = r->stamp;
+						w++;
+					}
+			}
+			if (expected) (n != 0) ? fprintf(expected, "%d\n", w) : fprintf(expected, "F\n");
+			break;
+
+		case 'R':
+			r->root = c->u;
+			break;
+
+		case 'P':
+			if (!search(r, r->root, c->u) || r->seen[c->v] != r->seen[c->u])
+			{
+				if (expected) fprintf(expected, "F\n");
+				break;
+			}
+			/* the ancestors of u are marked, the first one of v is the lowest common ancestor */
+			r->stamp++;
+			for (w = c->u; w != -1; w = r->parent[w])
+				r->mark[w] = r->stamp;
+			for (w = c->v; r->mark[w] != r->stamp; w = r->parent[w])
+				;
+			if (expected) fprintf(expected, "%d\n", w + 1);
+			break;
+
+		case 'D':
+			if (!search(r, c->u, c->v))
+			{
+				if (expected) fprintf(expected, "F\n");
+				break;
+			}
+			for (w = c->v, n = 0; w != c->u; w = r->parent[w])
+				n++;
+			if (expected) fprintf(expected, "%d\n", n);
+			break;
+
+		case 'W':
+			insertEdge(r, c->u, c->v, c->x);
+			if (expected) fprintf(expected, "%ld\n", r->total);
+			break;
+
+		case 'E':
+			if ((k = heaviestEdge(r, c->u, c->v)) == -1)
+			{
+				if (expected) fprintf(expected, "F\n");
+				break;
+			}
+			if (expected) fprintf(expected, "%ld %d %d\n", r->weight[k], r->endA[k] + 1, r->endB[k] + 1);
+			break;
+
+		case 'V':
+			n = (r->nFree > 0) ? r->freeIds[--r->nFree] : r->size++;
+			r->alive[n] = 1;
+			r->val[n] = 0;
+			if (expected) fprintf(expected, "%d\n", n + 1);
+			break;
+
+		case 'K':
+			if (r->deg[c->u] == 0 && r->msfDeg[c->u] == 0)
+			{
+				r->alive[c->u] = 0;
+				r->freeIds[r->nFree++] = c->u;
+			}
+			break;
+	}
+}
+
+/* @brief: Function that picks a random node that is not deleted.
+ *		   Receives the forest.
+ */
+int randomNode(Reference * r)
+{
+	int v;
+
+	do
+		v = xorshiftBelow(&seed, r->size);
+	while (!r->alive[v]);
+
+	return v;
+}
+
+/* @brief: Function that generates a random trace for a target, following a reference graph so that most cuts hit
+ *		   an edge. In a forest most links join two trees and the others are ignored, and GRAPH also links the
+ *		   ends of an edge again. The weights of W are all different, so that the heaviest edge of a
+ *		   path is the same for the reference and the target.
+ *
+ *		   Receives the number of nodes, the number of commands and the target.
+ */
+Trace* generateTrace(int n, int ops, Target * target)
+{
+	Trace * trace = (Trace*) malloc(sizeof(Trace));
+	Reference * r = createReference(n, n + ops);
+	Command * c;
+	int i, k, alive = n, mix = strlen(target->mix), ignoredU = -1, ignoredV = -1;
+
+	trace->n = n;
+	trace->size = ops;
+	trace->commands = (Command*) malloc(sizeof(Command)*ops);
+
+	for (i = 0; i < ops; i++)
+	{
+		c = &trace->commands[i];
+		c->u = randomNode(r);
+		c->v = randomNode(r);
+		c->x = xorshiftBelow(&seed, 21) - 10;
+		c->command = target->mix[xorshiftBelow(&seed, mix)];
+
+		/* the chain is linked from its first node and a Z of its last one ends the window of ./test -j */
+		if (i < target->chain - 1)
+		{
+			c->command = 'L';
+			c->u = i;
+			c->v = i + 1;
+		}
+		else if (i == target->chain - 1)
+		{
+			c->command = 'Z';
+			c->u = i;
+		}
+
+		if (c->command == 'L' && target->kind == GRAPH)
+		{
+			/* a cycle most of the times and a repeated edge some times */
+			if (r->deg[c->u] > 0 && xorshiftBelow(&seed, 4) == 0)
+				c->v = r->adj[c->u][xorshiftBelow(&seed, r->deg[c->u])];
+		}
+		else if (c->command == 'L')
+		{
+			/* a few tries for two trees, a link of connected nodes is kept some times to check that it is ignored */
+			for (k = 0; k < 4 && search(r, c->u, c->v); k++)
+				c->v = randomNode(r);
+			if (search(r, c->u, c->v) && xorshiftBelow(&seed, 4) != 0)
+				c->command = 'Q';
+			else if (search(r, c->u, c->v))
+			{
+				ignoredU = c->u;
+				ignoredV = c->v;
+			}
+		}
+		else if (c->command == 'C' && ignoredU != -1 && r->alive[ignoredU] && r->alive[ignoredV] &&
+			xorshiftBelow(&seed, 4) == 0)
+		{
+			/* the ends of the last link that was ignored, the cut does nothing unless they were linked since */
+			c->u = ignoredU;
+			c->v = ignoredV;
+			ignoredU = -1;
+		}
+		else if (c->command == 'C')
+		{
+			/* most cuts take an edge of a random node */
+			for (k = 0; k < 4 && r->deg[c->u] == 0; k++)
+				c->u = randomNode(r);
+			if (r->deg[c->u] > 0 && xorshiftBelow(&seed, 8) != 0)
+				c->v = r->adj[c->u][xorshiftBelow(&seed, r->deg[c->u])];
+		}
+		else if (c->command == 'W')
+			c->x = ((long)(xorshiftBelow(&seed, 2001) - 1000) * ops + i) * WEIGHT_SCALE;
+		else if (c->command == 'V')
+			alive++;
+		else if (c->command == 'K' && alive > 2 && r->deg[c->u] == 0 && r->msfDeg[c->u] == 0)
+			alive--;
+		else if (c->command == 'K')
+			c->command = 'Z';
+
+		execute(r, c, target->kind, NULL);
+	}
+
+	freeReference(r);
+	return trace;
+}
+
+/* @brief: Function to free the memory of a trace.
+ *		   Receives a pointer to the trace.
+ */
+void freeTrace(Trace * trace)
+{
+	free(trace->commands);
+	free(trace);
+}
+
+/* @brief: Function that answers a trace with the reference graph and writes the expected output.
+ *
+ *		   Receives the trace, the kind of the target and the file of the expected output.
+ *		   Returns 0 if the trace is not valid, because it uses a node that does not exist, and 1 otherwise.
+ */
+int simulate(Trace * trace, int kind, FILE * expected)
+{
+	Reference * r = createReference(trace->n, trace->n + trace->size);
+	Command * c;
+	int i, valid = 1;
+
+	for (i = 0; i < trace->size && valid; i++)
+	{
+		c = &trace->commands[i];
+		if ((arity(c->command) >= 1 && (c->u >= r->size || !r->alive[c->u])) ||
+			(arity(c->command) >= 2 && (c->v >= r->size || !r->alive[c->v])))
+			valid = 0;
+		else
+			execute(r, c, kind, expected);
+	}
+
+	freeReference(r);
+	return valid;
+}
+
+/* @brief: Function that writes a trace as text traces ended by X, one for each part between two RESTART
+ *		   commands. The first part goes to path and part k to path.k.
+ *
+ *		   Receives the trace and the path of the file.
+ *		   Returns the number of parts.
+ */
+int writeTrace(Trace * trace, const char * path)
+{
+	char name[256];
+	FILE * file = NULL;
+	Writer * out = NULL;
+	Command * c;
+	int i, parts = 0;
+
+	for (i = 0; i <= trace->size; i++)
+	{
+		if (out == NULL)
+		{
+			(parts == 0) ? sprintf(name, "%.200s", path) : sprintf(name, "%.200s.%d", path, parts);
+			if ((file = fopen(name, "w")) == NULL)
+			{
+				fprintf(stderr, "ERROR: Cannot write %s\n", name);
+				exit(EXIT_FAILURE);
+			}
+			out = openWriter(file);
+			writeLong(out, trace->n);
+			writeChar(out, '\n');
+			parts++;
+		}
+
+		if (i == trace->size || trace->commands[i].command == RESTART)
+		{
+			writeString(out, "X\n");
+			closeWriter(out);
+			fclose(file);
+			out = NULL;
+			continue;
+		}
+
+		c = &trace->commands[i];
+		writeChar(out, (char) c->command);
+		if (arity(c->command) >= 1)
+		{
+			writeChar(out, ' ');
+			writeLong(out, c->u + 1);
+		}
+		if (arity(c->command) >= 2)
+		{
+			writeChar(out, ' ');
+			writeLong(out, c->v + 1);
+		}
+		if (arity(c->command) >= 3)
+		{
+			writeChar(out, ' ');
+			writeLong(out, c->x);
+		}
+		writeChar(out, '\n');
+	}
+
+	return parts;
+}
+
+/* @brief: Function that runs a trace through a target and compares its output with the one of the reference. The
+ *		   parts of a trace with restarts are run one after the other, on the snapshot and the log of the target,
+ *		   which start empty.
+ *
+ *		   Receives the trace, the target and where the first different line is stored.
+ *		   Returns 0 if the outputs differ or ./test fails and 1 if they are the same or the trace is not valid for
+ *		   the target.
+ */
+int check(Trace * trace, Target * target, int * line)
+{
+	char command[512], part[64];
+	FILE * expected = fopen(EXPECTED_FILE, "w");
+	int valid, parts, k, ok = 1;
+
+	*line = 0;
+	if (expected == NULL)
+	{
+		fprintf(stderr, "ERROR: Cannot write %s\n", EXPECTED_FILE);
+		exit(EXIT_FAILURE);
+	}
+	valid = simulate(trace, target->kind, expected);
+	fclose(expected);
+	if (!valid)
+		return 1;
+
+	remove(SNAPSHOT_FILE);
+	remove(LOG_FILE);
+	parts = writeTrace(trace, TRACE_FILE);
+	for (k = 0; k < parts; k++)
+	{
+		(k == 0) ? sprintf(part, "%s", TRACE_FILE) : sprintf(part, "%s.%d", TRACE_FILE, k);
+		sprintf(command, "%.100s < %s %s %s 2> /dev/null", target->program, part, (k == 0) ? ">" : ">>",
+			OUTPUT_FILE);
+		ok = ok && system(command) == 0;
+		if (k > 0)
+			remove(part);
+	}
+	if (!ok)
+		return 0;
+
+	return compareOutputs(line);
+}
+
+/* @brief: Function that compares the expected output with the one of ./test line by line. An expected line can
+ *		   hold some answers separated by |, the line of ./test must be one of them.
+ *
+ *		   Receives where the number of the first different line is stored.
+ *		   Returns 1 if they are the same and 0 otherwise.
+ */
+int compareOutputs(int * line)
+{
+	FILE * expected = fopen(EXPECTED_FILE, "r"), * output = fopen(OUTPUT_FILE, "r");
+	static char a[LINE_SIZE], b[LINE_SIZE];
+	char * ra, * rb, * answer;
+	int same = 1;
+
+	if (expected == NULL || output == NULL)
+	{
+		fprintf(stderr, "ERROR: Cannot read the outputs\n");
+		exit(EXIT_FAILURE);
+	}
+
+	for (*line = 1; same; (*line)++)
+	{
+		ra = fgets(a, sizeof(a), expected);
+		rb = fgets(b, sizeof(b), output);
+		if (ra == NULL || rb == NULL)
+		{
+			same = (ra == rb);
+			break;
+		}
+		a[strcspn(a, "\n")] = b[strcspn(b, "\n")] = '\0';
+		for (answer = strtok(a, "|"), same = 0; answer != NULL && !same; answer = strtok(NULL, "|"))
+			same = (strcmp(answer, b) == 0);
+	}
+
+	fclose(expected);
+	fclose(output);
+	return same;
+}
+
+/* @brief: Function that shrinks a failing trace by removing blocks of commands that it still fails without,
+ *		   halving the block after each pass until a pass can not remove any single command. Then, when the trace
+ *		   does not create nodes, the nodes are numbered in the order they are used and the unused ones dropped.
+ *
+ *		   Receives the failing trace and the target.
+ *		   Returns a new trace.
+ */
+Trace* shrink(Trace * trace, Target * target)
+{
+	Trace * small = (Trace*) malloc(sizeof(Trace)), candidate;
+	Command * c;
+	int block, start, line, i, removed = 0, * number;
+
+	small->n = trace->n;
+	small->size = trace->size;
+	small->commands = (Command*) malloc(sizeof(Command)*trace->size);
+	memcpy(small->commands, trace->commands, sizeof(Command)*trace->size);
+	candidate.n = trace->n;
+	candidate.commands = (Command*) malloc(sizeof(Command)*trace->size);
+
+	for (block = (small->size + 1) / 2; block >= 1; block = (block > 1) ? block / 2 : removed)
+		for (start = 0, removed = 0; start < small->size; )
+		{
+			/* the trace without the commands [start, start + block[ */
+			memcpy(candidate.commands, small->commands, sizeof(Command)*start);
+			candidate.size = (start + block < small->size) ? small->size - block : start;
+			memcpy(candidate.commands + start, small->commands + start + block,
+				sizeof(Command)*(candidate.size - start));
+
+			if (!check(&candidate, target, &line))
+			{
+				memcpy(small->commands, candidate.commands, sizeof(Command)*candidate.size);
+				small->size = candidate.size;
+				removed = 1;
+			}
+			else
+				start += block;
+		}
+
+	for (start = 0; start < small->size && small->commands[start].command != 'V'; start++)
+		;
+	if (start == small->size)
+	{
+		/* number[v] is the new number of v, -1 while v is not used */
+		number = (int*) malloc(sizeof(int)*small->n);
+		for (i = 0; i < small->n; i++)
+			number[i] = -1;
+		for (i = 0, candidate.n = 0; i < small->size; i++)
+		{
+			c = &candidate.commands[i];
+			*c = small->commands[i];
+			if (arity(c->command) >= 1 && number[c->u] == -1)
+				number[c->u] = candidate.n++;
+			c->u = (arity(c->command) < 1) ? 0 : number[c->u];
+			if (arity(c->command) >= 2 && number[c->v] == -1)
+				number[c->v] = candidate.n++;
+			c->v = (arity(c->command) < 2) ? 0 : number[c->v];
+		}
+		candidate.size = small->size;
+		candidate.n = (candidate.n > 0) ? candidate.n : 1;
+		if (!check(&candidate, target, &line))
+		{
+			small->n = candidate.n;
+			memcpy(small->commands, candidate.commands, sizeof(Command)*small->size);
+		}
+		free(number);
+	}
+
+	free(candidate.commands);
+	return small;
+}
+
+/* @brief: Function that times a target on PERF_TRACE, prints the change from the last baseline of the target and
+ *		   appends the new one, as the commit, the target and the commands per second.
+ *
+ *		   Receives the path of the file of baselines and the target.
+ */
+void recordBaseline(const char * path, Target * target)
+{
+	char command[256], line[256], commit[64] = "unknown", lastCommit[64] = "", other[64], name[64];
+	double perSecond = 0, last = 0, value, seconds;
+	unsigned long count;
+	FILE * file;
+
+	sprintf(command, "%s | %.100s > /dev/null 2> %s", PERF_TRACE, target->program, STATS_FILE);
+	if (system(command) != 0 || (file = fopen(STATS_FILE, "r")) == NULL)
+	{
+		fprintf(stderr, "ERROR: The baseline of %s failed\n", target->name);
+		return;
+	}
+	while (fgets(line, sizeof(line), file) != NULL)
+		sscanf(line, "commands: %lu in %lf s (%lf per second)", &count, &seconds, &perSecond);
+	fclose(file);
+
+	if (system("git rev-parse --short HEAD > " COMMIT_FILE " 2> /dev/null") == 0 &&
+		(file = fopen(COMMIT_FILE, "r")) != NULL)
+	{
+		if (fscanf(file, "%63s", commit) != 1)
+			strcpy(commit, "unknown");
+		fclose(file);
+	}
+
+	if ((file = fopen(path, "r")) != NULL)
+	{
+		while (fgets(line, sizeof(line), file) != NULL)
+			if (sscanf(line, "%63s %63s %lf", other, name, &value) == 3 && strcmp(name, target->name) == 0)
+			{
+				strcpy(lastCommit, other);
+				last = value;
+			}
+		fclose(file);
+	}
+
+	printf("%-8s %12.0f commands per second", target->name, perSecond);
+	if (last > 0)
+		printf(" (%+.1f%% from %s)", 100 * (perSecond - last) / last, lastCommit);
+	printf("\n");
+
+	if ((file = fopen(path, "a")) == NULL)
+	{
+		fprintf(stderr, "ERROR: Cannot write %s\n", path);
+		return;
+	}
+	fprintf(file, "%s %s %.0f\n", commit, target->name, perSecond);
+	fclose(file);
+}
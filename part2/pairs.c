@@ -0,0 +1,40 @@
+#include "pairs.h"
+
+/* @brief: Function that hashes an unordered pair of vertices, the caller masks it to the size of its table.
+ *
+ *		   Receives the vertices u and v.
+ */
+unsigned long pairHash(int u, int v)
+{
+	unsigned long a = (u < v) ? u : v, b = (u < v) ? v : u;
+
+	return (a * 2654435761UL) ^ (b * 40503UL + (b << 16));
+}
+
+/* @brief: Function that empties a slot of a table. The following entries of the cluster are moved back when
+ *		   their home slot allows it, so that no lookup stops too early.
+ *
+ *		   Receives the table, its mask, the slot, the function that gives the home slot of an entry and the owner
+ *		   of the entries.
+ */
+void removePairSlot(int * table, unsigned long mask, unsigned long slot, PairHome home, void * owner)
+{
+	unsigned long next = slot, start;
+
+	table[slot] = -1;
+	while (1)
+	{
+		next = (next + 1) & mask;
+		if (table[next] == -1)
+			return;
+
+		start = home(owner, table[next]);
+		/* the entry can move to slot if slot is in the cyclic range [start, next[ */
+		if (((next - start) & mask) >= ((next - slot) & mask))
+		{
+			table[slot] = table[next];
+			table[next] = -1;
+			slot = next;
+		}
+	}
+}
@@ -0,0 +1,17 @@
+#ifndef PAIRS_H
+#define PAIRS_H
+
+/************************************************** NOTE ********************************************************/
+/*  Hash tables of unordered pairs of vertices with linear probing, shared by the Euler tour trees, the HDT     */
+/*  graph and the offline engine. A table is an array of mask+1 slots that hold the index of an entry or -1;    */
+/*  the entries themselves live in the structure that owns the table, which gives their home slot through a     */
+/*  function so that a deletion can move the rest of the cluster back.                                         */
+/****************************************************************************************************************/
+
+/* Home slot of an entry, given the owner of the table and the index of the entry. */
+typedef unsigned long (*PairHome)(void * owner, int entry);
+
+unsigned long pairHash(int u, int v);
+void removePairSlot(int * table, unsigned long mask, unsigned long slot, PairHome home, void * owner);
+
+#endif
@@ -0,0 +1,481 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "snapshot.h"
+
+/************************************************ SIGNATURES ****************************************************/
+void writeForest(FILE * file, Forest * t);
+Forest* readForest(const char ** cursor, const char * end);
+void writePadding(FILE * file);
+const char* skipPadding(const char * cursor, const char * begin);
+int handleOf(LCT node);
+LCT nodeAt(Forest * t, int v);
+int changesForest(int command);
+int readLogWord(FILE * file, unsigned long * word);
+
+/*****************************************************************************************************************/
+
+/* @brief: Function that writes the forest of the L and C commands and the minimum spanning forest to a snapshot.
+ *		   The file is written next to path and renamed at the end, so path always holds a whole snapshot.
+ *
+ *		   Receives the path, the forest, the minimum spanning forest (or NULL), the root of the P and D commands
+ *		   and the epoch of the snapshot.
+ *		   Returns 1 if the snapshot was written.
+ */
+int saveSnapshot(const char * path, Forest * t, MSF * msf, int root, int epoch)
+{
+	char * tmp = (char*) malloc(strlen(path) + 5);
+	SnapHeader header;
+	SnapMSF snapMSF;
+	FILE * file;
+	int ok;
+
+	sprintf(tmp, "%s.tmp", path);
+	if ((file = fopen(tmp, "wb")) == NULL)
+	{
+		free(tmp);
+		return 0;
+	}
+
+	memset(&header, 0, sizeof(SnapHeader));
+	memcpy(header.magic, SNAPSHOT_MAGIC, 4);
+	header.version = SNAPSHOT_VERSION;
+	header.order = SNAPSHOT_ORDER;
+	header.nodeSize = sizeof(SnapNode);
+	header.epoch = epoch;
+	header.root = root;
+	header.hasMSF = (msf != NULL);
+	fwrite(&header, sizeof(SnapHeader), 1, file);
+	writeForest(file, t);
+
+	if (msf != NULL)
+	{
+		memset(&snapMSF, 0, sizeof(SnapMSF));
+		snapMSF.weight = msf->weight;
+		snapMSF.V = msf->V;
+		snapMSF.nFree = msf->nFree;
+		fwrite(&snapMSF, sizeof(SnapMSF), 1, file);
+		fwrite(msf->endA, sizeof(int), msf->V, file);
+		fwrite(msf->endB, sizeof(int), msf->V, file);
+		fwrite(msf->freeEdges, sizeof(int), msf->nFree, file);
+		writePadding(file);
+		writeForest(file, msf->nodes);
+	}
+
+	ok = !ferror(file);
+	ok = (fclose(file) == 0) && ok;
+	ok = ok && rename(tmp, path) == 0;
+	if (!ok)
+		remove(tmp);
+	free(tmp);
+
+	return ok;
+}
+
+/* @brief: Function that writes the free handles and the nodes of a forest, one chunk at a time.
+ *
+ *		   Receives the file and the forest.
+ */
+void writeForest(FILE * file, Forest * t)
+{
+	SnapForest header;
+	SnapNode * nodes = (SnapNode*) malloc(sizeof(SnapNode) << CHUNK_BITS);
+	LCT node;
+	int v, n = 0;
+
+	header.size = t->size;
+	header.nFree = t->nFree;
+	fwrite(&header, sizeof(SnapForest), 1, file);
+	fwrite(t->freeIds, sizeof(int), t->nFree, file);
+	writePadding(file);
+
+	for (v = 0; v < t->size; v++)
+	{
+		node = NODE(t, v);
+		nodes[n].val = node->val;
+		nodes[n].sum = node->sum;
+		nodes[n].min = node->min;
+		nodes[n].max = node->max;
+		nodes[n].add = node->add;
+		nodes[n].left = handleOf(node->left);
+		nodes[n].right = handleOf(node->right);
+		nodes[n].hook = handleOf(node->hook);
+		nodes[n].argmin = handleOf(node->argmin);
+		nodes[n].argmax = handleOf(node->argmax);
+		nodes[n].flip = node->flip;
+		nodes[n].size = node->size;
+		nodes[n].vir = node->vir;
+		nodes[n].tot = node->tot;
+		nodes[n].id = node->id;
+		nodes[n].vertex = node->vertex;
+
+		if (++n == (1 << CHUNK_BITS) || v == t->size - 1)
+		{
+			fwrite(nodes, sizeof(SnapNode), n, file);
+			n = 0;
+		}
+	}
+
+	free(nodes);
+}
+
+/* @brief: Function that loads a snapshot written by saveSnapshot. The file is memory mapped by the reader of
+ *		   io.c and its nodes are copied to a new forest in one pass, turning the handles back into pointers.
+ *
+ *		   Receives the path and where the forest, the minimum spanning forest (NULL if the snapshot has none), the
+ *		   root and the epoch are stored.
+ *		   Returns 1 if it was loaded, 0 if there is no file and -1 if the file is not a valid snapshot.
+ */
+int loadSnapshot(const char * path, Forest ** t, MSF ** msf, int * root, int * epoch)
+{
+	const SnapHeader * header;
+	const SnapMSF * snapMSF;
+	const char * begin, * cursor, * end;
+	Reader * in;
+	MSF * m = NULL;
+	int ok = 0;
+
+	if ((in = openReader(path)) == NULL)
+		return 0;
+	if (!in->mapped || in->len < sizeof(SnapHeader))
+	{
+		closeReader(in);
+		return -1;
+	}
+
+	begin = (const char*) in->buf;
+	end = begin + in->len;
+	header = (const SnapHeader*) begin;
+	cursor = begin + sizeof(SnapHeader);
+	*t = NULL;
+
+	if (memcmp(header->magic, SNAPSHOT_MAGIC, 4) == 0 && header->version == SNAPSHOT_VERSION &&
+		header->order == SNAPSHOT_ORDER && header->nodeSize == (int)sizeof(SnapNode) &&
+		(*t = readForest(&cursor, end)) != NULL)
+	{
+		ok = 1;
+		if (header->hasMSF)
+		{
+			snapMSF = (const SnapMSF*) cursor;
+			cursor += sizeof(SnapMSF);
+			if (cursor > end || snapMSF->V < 0 || snapMSF->nFree < 0 || snapMSF->nFree > snapMSF->V ||
+				end - cursor < (long)sizeof(int)*(2*snapMSF->V + snapMSF->nFree))
+				ok = 0;
+			else
+			{
+				m = (MSF*) malloc(sizeof(MSF));
+				m->V = snapMSF->V;
+				m->nFree = snapMSF->nFree;
+				m->weight = snapMSF->weight;
+				m->endA = (int*) malloc(sizeof(int)*(m->V > 0 ? m->V : 1));
+				m->endB = (int*) malloc(sizeof(int)*(m->V > 0 ? m->V : 1));
+				m->freeEdges = (int*) malloc(sizeof(int)*(m->V > 0 ? m->V : 1));
+				memcpy(m->endA, cursor, sizeof(int)*m->V);
+				cursor += sizeof(int)*m->V;
+				memcpy(m->endB, cursor, sizeof(int)*m->V);
+				cursor += sizeof(int)*m->V;
+				memcpy(m->freeEdges, cursor, sizeof(int)*m->nFree);
+				cursor = skipPadding(cursor + sizeof(int)*m->nFree, begin);
+				if ((m->nodes = readForest(&cursor, end)) == NULL)
+				{
+					free(m->endA);
+					free(m->endB);
+					free(m->freeEdges);
+					free(m);
+					m = NULL;
+					ok = 0;
+				}
+			}
+		}
+		if (ok)
+		{
+			*root = header->root;
+			*epoch = header->epoch;
+		}
+		else
+		{
+			freeLCT(*t);
+			*t = NULL;
+		}
+	}
+
+	*msf = m;
+	closeReader(in);
+
+	return ok ? 1 : -1;
+}
+
+/* @brief: Function that reads a forest of a snapshot and moves the cursor after it.
+ *
+ *		   Receives where the cursor is and the end of the file.
+ *		   Returns the forest or NULL if the file ends before it does.
+ */
+Forest* readForest(const char ** cursor, const char * end)
+{
+	const char * begin = *cursor;
+	const SnapForest * header = (const SnapForest*) begin;
+	const SnapNode * nodes;
+	Forest * t;
+	LCT node;
+	int v;
+
+	if (end - begin < (long)sizeof(SnapForest) || header->size < 0 || header->nFree < 0 ||
+		header->nFree > header->size)
+		return NULL;
+
+	nodes = (const SnapNode*) skipPadding(begin + sizeof(SnapForest) + sizeof(int)*header->nFree, begin);
+	if ((const char*) nodes > end || (end - (const char*) nodes) / (long)sizeof(SnapNode) < header->size)
+		return NULL;
+
+	t = allocLct(header->size);
+	for (v = 0; v < header->size; v++)
+	{
+		node = NODE(t, v);
+		node->val = nodes[v].val;
+		node->sum = nodes[v].sum;
+		node->min = nodes[v].min;
+		node->max = nodes[v].max;
+		node->add = nodes[v].add;
+		node->left = nodeAt(t, nodes[v].left);
+		node->right = nodeAt(t, nodes[v].right);
+		node->hook = nodeAt(t, nodes[v].hook);
+		node->argmin = nodeAt(t, nodes[v].argmin);
+		node->argmax = nodeAt(t, nodes[v].argmax);
+		node->flip = nodes[v].flip;
+		node->size = nodes[v].size;
+		node->vir = nodes[v].vir;
+		node->tot = nodes[v].tot;
+		node->id = nodes[v].id;
+		node->vertex = nodes[v].vertex;
+	}
+
+	while (t->maxFree < header->nFree)
+		t->maxFree *= 2;
+	t->freeIds = (int*) realloc(t->freeIds, sizeof(int)*t->maxFree);
+	memcpy(t->freeIds, begin + sizeof(SnapForest), sizeof(int)*header->nFree);
+	t->nFree = header->nFree;
+
+	*cursor = (const char*)(nodes + header->size);
+	return t;
+}
+
+/* @brief: Function that opens the log. A new log starts with its header, which holds the epoch of the snapshot
+ *		   it follows, an old one is cut after its last whole record and appended to.
+ *
+ *		   Receives the path, the epoch and where the records of the old log end (0 for a new log).
+ *		   Returns the writer of the log or NULL if the file can not be opened.
+ */
+Writer* openLog(const char * path, int epoch, long end)
+{
+	FILE * file;
+	Writer * log;
+
+	if (end > 0 && !truncateFile(path, end))
+		return NULL;
+	if ((file = fopen(path, (end > 0) ? "ab" : "wb")) == NULL)
+		return NULL;
+
+	log = openWriter(file);
+	if (end == 0)
+	{
+		writeString(log, LOG_MAGIC);
+		writeWord(log, LOG_VERSION);
+		writeWord(log, (unsigned long) epoch);
+	}
+	return log;
+}
+
+/* @brief: Function that flushes and closes the log.
+ *		   Receives the writer of the log.
+ */
+void closeLog(Writer * log)
+{
+	FILE * file = log->stream;
+
+	closeWriter(log);
+	fclose(file);
+}
+
+/* @brief: Function that writes a command to the log as a binary record, if it changes the forest.
+ *
+ *		   Receives the writer of the log, the command and its arguments as they were read.
+ */
+void logCommand(Writer * log, int command, long arg[MAX_ARGS])
+{
+	int i;
+
+	if (!changesForest(command))
+		return;
+
+	writeChar(log, (char) command);
+	for (i = 0; i < arity(command); i++)
+	{
+		writeWord(log, (unsigned long) arg[i] & 0xFFFFFFFFUL);
+		/* the value of A and W is any long, its high word follows (shifted twice, long may have 32 bits) */
+		if (i == 2)
+			writeWord(log, ((unsigned long) arg[i] >> 16) >> 16);
+	}
+}
+
+/* @brief: Function that runs the commands of the log on the forest, without printing anything. It stops at the
+ *		   first record that is not whole, the end of a log that was being written when the program stopped.
+ *
+ *		   Receives the path of the log, the forest, the minimum spanning forest, the root of the P and D commands,
+ *		   the epoch of the snapshot the forest was loaded from (0 if none) and where the position after the last
+ *		   whole record is stored (0 when the log must be written again).
+ *		   Returns the number of commands run, 0 when there is no log or it is older than the snapshot, and -1
+ *		   when it is newer, so it does not follow this snapshot, or it is not a log of this version.
+ */
+int replayLog(const char * path, Forest * t, MSF ** msf, int * root, int epoch, long * end)
+{
+	FILE * file;
+	char magic[4];
+	unsigned long word[MAX_ARGS + 1], version, logEpoch;
+	long arg[MAX_ARGS];
+	int command, u, v, i, n = 0;
+
+	*end = 0;
+	if ((file = fopen(path, "rb")) == NULL)
+		return 0;
+	/* a header cut by a crash is a log without commands */
+	if (fread(magic, 1, 4, file) != 4 || !readLogWord(file, &version) || !readLogWord(file, &logEpoch))
+	{
+		fclose(file);
+		return 0;
+	}
+	if (memcmp(magic, LOG_MAGIC, 4) != 0 || version != LOG_VERSION || logEpoch > (unsigned long) epoch)
+	{
+		fclose(file);
+		return -1;
+	}
+	if (logEpoch < (unsigned long) epoch)
+	{
+		fclose(file);
+		return 0;
+	}
+
+	*end = ftell(file);
+	while ((command = getc(file)) != EOF && changesForest(command))
+	{
+		for (i = 0; i < arity(command) + (arity(command) > 2) && readLogWord(file, &word[i]); i++)
+			;
+		if (i < arity(command) + (arity(command) > 2))
+			break;
+		*end = ftell(file);
+
+		for (i = 0; i < MAX_ARGS; i++)
+			arg[i] = (i < arity(command)) ? (long) word[i] : 0;
+		if (arity(command) > 2)
+		{
+			word[2] |= (word[3] << 16) << 16;
+			arg[2] = (word[2] > LONG_MAX) ? -(long)(ULONG_MAX - word[2]) - 1 : (long) word[2];
+		}
+
+		u = (int)arg[0] - 1;
+		v = (int)arg[1] - 1;
+		if ((arity(command) > 0 && !aliveNode(t, u)) || (arity(command) > 1 && !aliveNode(t, v)))
+			continue;
+
+		switch (command)
+		{
+			case 'L':
+				link(t, u, v);
+				break;
+			case 'C':
+				cut(t, u, v);
+				break;
+			case 'A':
+				pathAdd(t, u, v, arg[2]);
+				break;
+			case 'R':
+				*root = u;
+				break;
+			case 'V':
+				newNode(t);
+				break;
+			case 'K':
+				deleteVertex(t, *msf, u);
+				break;
+			case 'W':
+				if (*msf == NULL) *msf = createMSF(t->size); else growMSF(*msf, t->size);
+				insertEdge(*msf, u, v, arg[2]);
+				break;
+		}
+		n++;
+	}
+
+	fclose(file);
+	return n;
+}
+
+/* @brief: Function that tells if a command changes the forest, the minimum spanning forest or the root, which
+ *		   are the ones kept in the log.
+ *
+ *		   Receives the command.
+ */
+int changesForest(int command)
+{
+	switch (command)
+	{
+		case 'L': case 'C': case 'A': case 'R': case 'V': case 'K': case 'W':
+			return 1;
+		default:
+			return 0;
+	}
+}
+
+/* @brief: Function that writes zeros until the position of the file is a multiple of 8.
+ *		   Receives the file.
+ */
+void writePadding(FILE * file)
+{
+	long pos = ftell(file);
+
+	while (pos++ % 8 != 0)
+		fputc(0, file);
+}
+
+/* @brief: Function that moves a cursor to the next multiple of 8 from the begin of the section.
+ *		   Receives the cursor and the begin of the section, which is itself at a multiple of 8.
+ */
+const char* skipPadding(const char * cursor, const char * begin)
+{
+	return cursor + ((8 - (cursor - begin) % 8) % 8);
+}
+
+/* @brief: Function that gives the handle of a node or -1 for NULL.
+ *		   Receives the node.
+ */
+int handleOf(LCT node)
+{
+	return (node != NULL) ? node->id : -1;
+}
+
+/* @brief: Function that gives the node of a handle of a snapshot, or NULL for -1 and handles out of the forest.
+ *		   Receives the forest and the handle.
+ */
+LCT nodeAt(Forest * t, int v)
+{
+	return (v >= 0 && v < t->size) ? NODE(t, v) : NULL;
+}
+
+/* @brief: Function that reads a 32 bit little endian word of the log.
+ *
+ *		   Receives the file and where the word is stored.
+ *		   Returns 1 if the 4 bytes were read.
+ */
+int readLogWord(FILE * file, unsigned long * word)
+{
+	int i, byte;
+
+	*word = 0;
+	for (i = 0; i < 4; i++)
+	{
+		if ((byte = getc(file)) == EOF)
+			return 0;
+		*word |= (unsigned long) byte << (8*i);
+	}
+	return 1;
+}
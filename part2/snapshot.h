@@ -0,0 +1,86 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "io.h"
+#include "LCT.h"
+
+/************************************************** NOTE ********************************************************/
+/*  A snapshot is the whole state of the forest in one file, with every pointer written as the handle of the    */
+/*  node it points to (-1 for NULL), so it does not depend on where the nodes were allocated. It is written in  */
+/*  the byte order and sizes of the machine, which the header records, and loaded with mmap and one pass that   */
+/*  turns the handles back into pointers. The sections start at multiples of 8 bytes:                          */
+/*      SnapHeader, the forest (SnapForest, its free handles, its nodes) and, when hasMSF is set, SnapMSF,       */
+/*      the ends of its edges, its free edges and its forest.                                                   */
+/*  The log has every command that changed the forest since the last snapshot. It starts with LOG_MAGIC,        */
+/*  LOG_VERSION and the epoch of that snapshot as 32 bit little endian words, followed by one record per        */
+/*  command as in a binary trace (see io.h), except that the value of A and W is a 64 bit word. A new snapshot  */
+/*  has the next epoch and empties the log, so a log older than the snapshot (a crash between the two) is       */
+/*  known to be in it already. A record cut by a crash is dropped from the log before new ones are appended.    */
+/****************************************************************************************************************/
+
+#define SNAPSHOT_MAGIC "LCTS"
+#define SNAPSHOT_VERSION 2
+#define SNAPSHOT_ORDER 0x01020304
+
+#define LOG_MAGIC "LCTL"
+#define LOG_VERSION 2
+
+typedef struct
+{
+	char magic[4];
+	int version;
+	/* SNAPSHOT_ORDER as written by the machine and sizeof(SnapNode), to refuse files of other machines */
+	int order;
+	int nodeSize;
+	int epoch;
+	int root;
+	int hasMSF;
+	int pad;
+
+} SnapHeader;
+
+typedef struct
+{
+	int size;
+	int nFree;
+
+} SnapForest;
+
+typedef struct
+{
+	long weight;
+	int V;
+	int nFree;
+
+} SnapMSF;
+
+/* @brief: A node of the LCT with handles in place of pointers. */
+typedef struct
+{
+	long val;
+	long sum;
+	long min;
+	long max;
+	long add;
+	int left;
+	int right;
+	int hook;
+	int argmin;
+	int argmax;
+	int flip;
+	int size;
+	int vir;
+	int tot;
+	int id;
+	int vertex;
+
+} SnapNode;
+
+int saveSnapshot(const char * path, Forest * t, MSF * msf, int root, int epoch);
+int loadSnapshot(const char * path, Forest ** t, MSF ** msf, int * root, int * epoch);
+Writer* openLog(const char * path, int epoch, long end);
+void closeLog(Writer * log);
+void logCommand(Writer * log, int command, long arg[MAX_ARGS]);
+int replayLog(const char * path, Forest * t, MSF ** msf, int * root, int epoch, long * end);
+
+#endif
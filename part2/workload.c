@@ -0,0 +1,334 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "io.h"
+#include "xorshift.h"
+
+/************************************************** NOTE ********************************************************/
+/*  Seeded workload generator. A profile gives the shape of a target forest over the nodes and the trace links  */
+/*  and cuts edges of that forest, so every link joins two trees and every cut removes an edge that exists. The */
+/*  node numbers are shuffled so that neighbours in the shape are not neighbours in memory.                     */
+/*      path: one long path, for deep access chains.                                                            */
+/*      star: every node hangs from the same center.                                                            */
+/*      caterpillar: a path with the other half of the nodes hanging from it.                                   */
+/*      powerlaw: preferential attachment, the degrees follow a power law.                                     */
+/*      random: every node hangs from a random earlier node.                                                    */
+/*      adversarial: a path whose queries go over the nodes in bit reversed order, the worst order for splaying. */
+/*      chain: a path linked in order from one end before any other command, so that the hooks of the LCT are   */
+/*      as long as the path.                                                                                    */
+/****************************************************************************************************************/
+
+#define PATH 0
+#define STAR 1
+#define CATERPILLAR 2
+#define POWERLAW 3
+#define RANDOM 4
+#define ADVERSARIAL 5
+#define CHAIN 6
+
+const char * profiles[] = { "path", "star", "caterpillar", "powerlaw", "random", "adversarial", "chain", NULL };
+
+/*
+ * @brief: The target forest and the edges of it that are in the forest of the trace, which are the first nPresent
+ *		   of edges.
+ */
+typedef struct
+{
+	int n;
+	int profile;
+	int nEdges;
+	int * endA;
+	int * endB;
+	int * edges;
+	int nPresent;
+	/* shuffled number of each node */
+	int * label;
+	/* queries made so far and the bits of the bit reversed order */
+	unsigned long queries;
+	int bits;
+	unsigned long seed;
+
+} Workload;
+
+/************************************************ SIGNATURES ****************************************************/
+Workload* createWorkload(int profile, int n, unsigned long seed);
+void freeWorkload(Workload * w);
+void addShapeEdge(Workload * w, int a, int b);
+void swapEdges(Workload * w, int i, int j);
+void nextQuery(Workload * w, int * u, int * v);
+void writeCommand(Writer * out, int binary, int command, int u, int v);
+
+/*****************************************************************************************************************/
+
+/* @brief: ./workload <profile> <nodes> <ops> [-s seed] [-m L,C,Q] [-b] or ./workload -l
+ *		   Writes a trace with ops commands to the standard output, the L, C and Q commands are picked with the
+ *		   weights of -m (40,10,50 by default). A link when the whole target forest is linked becomes a cut and a
+ *		   cut when nothing is linked becomes a link. With -b the trace is binary (see io.h). -l lists the
+ *		   profiles, one per line.
+ *         EX: ./workload path 100000 1000000 -s 7 -m 30,30,40 | ./test
+ */
+int main(int argc, char * argv[])
+{
+	Workload * w;
+	Writer * out;
+	unsigned long seed = 1;
+	int weights[3] = { 40, 10, 50 };
+	int profile, n, ops, i, k, r, u, v, command, binary = 0;
+
+	if (argc == 2 && strcmp(argv[1], "-l") == 0)
+	{
+		for (profile = 0; profiles[profile] != NULL; profile++)
+			printf("%s\n", profiles[profile]);
+		return EXIT_SUCCESS;
+	}
+
+	if (argc < 4)
+	{
+		fprintf(stderr, "usage: %s <profile> <nodes> <ops> [-s seed] [-m L,C,Q] [-b] or %s -l\n", argv[0], argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	for (profile = 0; profiles[profile] != NULL && strcmp(profiles[profile], argv[1]) != 0; profile++)
+		;
+	if (profiles[profile] == NULL)
+	{
+		fprintf(stderr, "ERROR: Unknown profile %s\n", argv[1]);
+		return EXIT_FAILURE;
+	}
+	n = atoi(argv[2]);
+	ops = atoi(argv[3]);
+
+	for (i = 4; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+			seed = strtoul(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc &&
+			sscanf(argv[++i], "%d,%d,%d", &weights[0], &weights[1], &weights[2]) == 3)
+			;
+		else if (strcmp(argv[i], "-b") == 0)
+			binary = 1;
+		else
+		{
+			fprintf(stderr, "ERROR: Unknown option %s\n", argv[i]);
+			return EXIT_FAILURE;
+		}
+	}
+	if (n < 1 || weights[0] < 0 || weights[1] < 0 || weights[2] < 0 || weights[0] + weights[1] + weights[2] == 0)
+	{
+		fprintf(stderr, "ERROR: Invalid nodes or weights\n");
+		return EXIT_FAILURE;
+	}
+
+	w = createWorkload(profile, n, seed);
+	out = openWriter(stdout);
+
+	if (binary)
+	{
+		writeString(out, BINARY_MAGIC);
+		writeWord(out, n);
+	}
+	else
+	{
+		writeLong(out, n);
+		writeChar(out, '\n');
+	}
+
+	for (i = 0; i < ops; i++)
+	{
+		r = xorshiftBelow(&w->seed, weights[0] + weights[1] + weights[2]);
+		command = (r < weights[0]) ? 'L' : (r < weights[0] + weights[1]) ? 'C' : 'Q';
+		if (w->profile == CHAIN && i < w->nEdges)
+			command = 'L';
+		if (command == 'L' && w->nPresent == w->nEdges)
+			command = 'C';
+		if (command == 'C' && w->nPresent == 0)
+			command = 'L';
+
+		if (command == 'Q' || w->nEdges == 0)
+		{
+			nextQuery(w, &u, &v);
+			writeCommand(out, binary, 'Q', u, v);
+			continue;
+		}
+
+		if (command == 'L')
+		{
+			k = w->nPresent + ((w->profile == CHAIN) ? 0 : xorshiftBelow(&w->seed, w->nEdges - w->nPresent));
+			swapEdges(w, k, w->nPresent++);
+		}
+		else
+		{
+			k = xorshiftBelow(&w->seed, w->nPresent);
+			swapEdges(w, k, --w->nPresent);
+		}
+		k = (command == 'L') ? w->edges[w->nPresent - 1] : w->edges[w->nPresent];
+		/* the order of the ends is random, so links and cuts reroot at both sides, except along a chain */
+		if (w->profile == CHAIN || (xorshift(&w->seed) & 1))
+			writeCommand(out, binary, command, w->label[w->endA[k]], w->label[w->endB[k]]);
+		else
+			writeCommand(out, binary, command, w->label[w->endB[k]], w->label[w->endA[k]]);
+	}
+
+	if (binary)
+		writeChar(out, 'X');
+	else
+		writeString(out, "X\n");
+
+	closeWriter(out);
+	freeWorkload(w);
+	return EXIT_SUCCESS;
+}
+
+/* @brief: Function that builds the target forest of a profile over n nodes and shuffles the numbers of the nodes.
+ *
+ *		   Receives the profile, the number of nodes and the seed.
+ */
+Workload* createWorkload(int profile, int n, unsigned long seed)
+{
+	Workload * w = (Workload*) malloc(sizeof(Workload));
+	int i, j, spine, tmp;
+
+	w->n = n;
+	w->profile = profile;
+	w->nEdges = 0;
+	w->nPresent = 0;
+	w->endA = (int*) malloc(sizeof(int)*n);
+	w->endB = (int*) malloc(sizeof(int)*n);
+	w->edges = (int*) malloc(sizeof(int)*n);
+	w->label = (int*) malloc(sizeof(int)*n);
+	w->queries = 0;
+	w->seed = xorshiftSeed(seed);
+	for (w->bits = 0; (1L << w->bits) < n; w->bits++)
+		;
+
+	spine = (n + 1) / 2;
+	for (i = 1; i < n; i++)
+	{
+		switch (profile)
+		{
+			case PATH: case ADVERSARIAL: case CHAIN:
+				addShapeEdge(w, i - 1, i);
+				break;
+			case STAR:
+				addShapeEdge(w, 0, i);
+				break;
+			case CATERPILLAR:
+				addShapeEdge(w, (i < spine) ? i - 1 : xorshiftBelow(&w->seed, spine), i);
+				break;
+			case POWERLAW:
+				/* an end of a random edge is a node picked with probability proportional to its degree */
+				if (w->nEdges == 0)
+					addShapeEdge(w, 0, i);
+				else
+				{
+					j = xorshiftBelow(&w->seed, w->nEdges);
+					addShapeEdge(w, (xorshift(&w->seed) & 1) ? w->endA[j] : w->endB[j], i);
+				}
+				break;
+			case RANDOM:
+				addShapeEdge(w, xorshiftBelow(&w->seed, i), i);
+				break;
+		}
+	}
+
+	/* labels are 1..n shuffled with Fisher-Yates */
+	for (i = 0; i < n; i++)
+		w->label[i] = i + 1;
+	for (i = n - 1; i > 0; i--)
+	{
+		j = xorshiftBelow(&w->seed, i + 1);
+		tmp = w->label[i];
+		w->label[i] = w->label[j];
+		w->label[j] = tmp;
+	}
+
+	return w;
+}
+
+/* @brief: Function to free the memory of a workload.
+ *		   Receives a pointer to the workload.
+ */
+void freeWorkload(Workload * w)
+{
+	free(w->endA);
+	free(w->endB);
+	free(w->edges);
+	free(w->label);
+	free(w);
+}
+
+/* @brief: Function that adds an edge to the target forest, it starts out of the forest of the trace.
+ *
+ *		   Receives the workload and the ends of the edge.
+ */
+void addShapeEdge(Workload * w, int a, int b)
+{
+	w->endA[w->nEdges] = a;
+	w->endB[w->nEdges] = b;
+	w->edges[w->nEdges] = w->nEdges;
+	w->nEdges++;
+}
+
+/* @brief: Function that switches two positions of the edges, used to move an edge in and out of the first
+ *		   nPresent.
+ *
+ *		   Receives the workload and the two positions.
+ */
+void swapEdges(Workload * w, int i, int j)
+{
+	int tmp = w->edges[i];
+
+	w->edges[i] = w->edges[j];
+	w->edges[j] = tmp;
+}
+
+/* @brief: Function that picks the nodes of the next query. The adversarial profile asks for the node in bit
+ *		   reversed order of the number of queries and for its mirror on the path, so that consecutive queries are
+ *		   far apart, the other profiles ask for random nodes.
+ *
+ *		   Receives the workload and where the nodes are stored.
+ */
+void nextQuery(Workload * w, int * u, int * v)
+{
+	unsigned long c, x;
+	int b;
+
+	if (w->profile != ADVERSARIAL || w->n < 2)
+	{
+		*u = w->label[xorshiftBelow(&w->seed, w->n)];
+		*v = w->label[xorshiftBelow(&w->seed, w->n)];
+		return;
+	}
+
+	do
+	{
+		c = w->queries++ & ((1UL << w->bits) - 1);
+		for (x = 0, b = 0; b < w->bits; b++)
+			x |= ((c >> b) & 1) << (w->bits - 1 - b);
+	} while (x >= (unsigned long) w->n);
+
+	*u = w->label[x];
+	*v = w->label[w->n - 1 - x];
+}
+
+/* @brief: Function that writes a command with two nodes.
+ *		   Receives the writer, binary, the command and the nodes.
+ */
+void writeCommand(Writer * out, int binary, int command, int u, int v)
+{
+	if (binary)
+	{
+		writeChar(out, (char) command);
+		writeWord(out, u);
+		writeWord(out, v);
+		return;
+	}
+
+	writeChar(out, (char) command);
+	writeChar(out, ' ');
+	writeLong(out, u);
+	writeChar(out, ' ');
+	writeLong(out, v);
+	writeChar(out, '\n');
+}
@@ -0,0 +1,30 @@
+#include "xorshift.h"
+
+/* @brief: Function that turns any seed into a state of the generator, which can not be 0.
+ *		   Receives the seed.
+ */
+unsigned long xorshiftSeed(unsigned long seed)
+{
+	unsigned long state = (seed * 2654435761UL + 2463534242UL) & 0xFFFFFFFFUL;
+
+	return (state != 0) ? state : 2463534242UL;
+}
+
+/* @brief: Function that gives the next 32 bit number of the generator.
+ *		   Receives the state.
+ */
+unsigned long xorshift(unsigned long * state)
+{
+	*state ^= (*state << 13) & 0xFFFFFFFFUL;
+	*state ^= *state >> 17;
+	*state ^= (*state << 5) & 0xFFFFFFFFUL;
+	return *state;
+}
+
+/* @brief: Function that gives a random number in [0, n[.
+ *		   Receives the state and n > 0.
+ */
+int xorshiftBelow(unsigned long * state, int n)
+{
+	return (int)(xorshift(state) % (unsigned long) n);
+}
@@ -0,0 +1,9 @@
+#ifndef XORSHIFT_H
+#define XORSHIFT_H
+
+/* 32 bit xorshift generator, the state is kept by the caller and must not be 0 (see xorshiftSeed). */
+unsigned long xorshiftSeed(unsigned long seed);
+unsigned long xorshift(unsigned long * state);
+int xorshiftBelow(unsigned long * state, int n);
+
+#endif